@@ -9,6 +9,9 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 
 #include <mpi.h>
 
@@ -43,8 +46,15 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
     keep_n_dumps( 2 ),
     keep_n_dumps_max( 10000 ),
     dump_deflate( 0 ),
+    dump_async( false ),
+    full_dump_every( 1 ),
+    full_dump( true ),
+    incremental_dumps( 0 ),
+    full_dump_slot( -1 ),
     dump_request( smpi->getSize() ),
-    file_grouping( 0 )
+    file_grouping( 0 ),
+    ranks_per_file( 0 ),
+    dump_comm( MPI_COMM_NULL )
 {
 
     if( PyTools::nComponents( "Checkpoints" ) > 0 ) {
@@ -73,8 +83,24 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
         
         PyTools::extract( "exit_after_dump", exit_after_dump, "Checkpoints" );
         
+        PyTools::extract( "full_dump_every", full_dump_every, "Checkpoints" );
+        if( full_dump_every < 1 ) {
+            full_dump_every = 1;
+        }
+        if( full_dump_every > 1 ) {
+            if( keep_n_dumps < 2 ) {
+                ERROR( "Checkpoints: full_dump_every > 1 requires keep_n_dumps >= 2" );
+            }
+            MESSAGE( 1, "Code will write a full dump every " << full_dump_every << " dumps, and incremental dumps in between" );
+        }
+        
         PyTools::extract( "dump_deflate", dump_deflate, "Checkpoints" );
         
+        PyTools::extract( "dump_async", dump_async, "Checkpoints" );
+        if( dump_async ) {
+            MESSAGE( 1, "Code will write checkpoint files asynchronously" );
+        }
+        
         if( PyTools::extract( "file_grouping", file_grouping, "Checkpoints" ) && file_grouping > 0 ) {
             if( file_grouping > ( unsigned int )( smpi->getSize() ) ) {
                 file_grouping = smpi->getSize();
@@ -82,6 +108,14 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
             MESSAGE( 1, "Code will group checkpoint files by "<< file_grouping );
         }
         
+        if( PyTools::extract( "ranks_per_file", ranks_per_file, "Checkpoints" ) && ranks_per_file > 1 ) {
+            if( ranks_per_file > ( unsigned int )( smpi->getSize() ) ) {
+                ranks_per_file = smpi->getSize();
+            }
+            MESSAGE( 1, "Code will aggregate the checkpoints of "<< ranks_per_file << " MPI processes per file" );
+            MPI_Comm_split( smpi->SMILEI_COMM_WORLD, smpi->getRank()/ranks_per_file, smpi->getRank(), &dump_comm );
+        }
+        
         if( params.restart ) {
             std::vector<std::string> restart_files;
             PyTools::extract( "restart_files", restart_files, "Checkpoints" );
@@ -89,7 +123,7 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
             // This will open all dumps and pick the last one
             for( unsigned int num_dump=0; num_dump<restart_files.size(); num_dump++ ) {
                 string dump_name=restart_files[num_dump];
-                hid_t fid = H5Fopen( dump_name.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+                hid_t fid = H5Fopen( dump_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
                 unsigned int stepStartTmp=0;
                 H5::getAttr( fid, "dump_step", stepStartTmp );
                 if( stepStartTmp>this_run_start_step ) {
@@ -97,6 +131,11 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
                     restart_file=dump_name;
                     dump_number=num_dump;
                     H5::getAttr( fid, "dump_number", dump_number );
+                    // The full dump that this incremental dump refers to must not be overwritten
+                    full_dump_slot = -1;
+                    if( H5::hasAttr( fid, "full_dump_slot" ) ) {
+                        H5::getAttr( fid, "full_dump_slot", full_dump_slot );
+                    }
                 }
                 H5Fclose( fid );
             }
@@ -143,6 +182,16 @@ Checkpoint::Checkpoint( Params &params, SmileiMPI *smpi ) :
     nDim_particle=params.nDim_particle;
 }
 
+Checkpoint::~Checkpoint()
+{
+    if( dump_writer.joinable() ) {
+        dump_writer.join();
+    }
+    if( dump_comm != MPI_COMM_NULL ) {
+        MPI_Comm_free( &dump_comm );
+    }
+}
+
 void Checkpoint::dump( VectorPatch &vecPatches, unsigned int itime, SmileiMPI *smpi, SimWindow *simWindow, Params &params )
 {
 
@@ -184,24 +233,57 @@ void Checkpoint::dump( VectorPatch &vecPatches, unsigned int itime, SmileiMPI *s
 void Checkpoint::dumpAll( VectorPatch &vecPatches, unsigned int itime,  SmileiMPI *smpi, SimWindow *simWin,  Params &params )
 {
     unsigned int num_dump=dump_number % keep_n_dumps;
+    // Skip the full dump which incremental dumps refer to
+    if( full_dump_every > 1 && ( int )num_dump == full_dump_slot ) {
+        dump_number++;
+        num_dump = dump_number % keep_n_dumps;
+    }
     
-    ostringstream nameDumpTmp( "" );
-    nameDumpTmp << "checkpoints" << PATH_SEPARATOR;
-    if( file_grouping>0 ) {
-        nameDumpTmp << setfill( '0' ) << setw( int( 1+log10( smpi->getSize()/file_grouping+1 ) ) ) << smpi->getRank()/file_grouping << PATH_SEPARATOR;
+    // Without a previous full dump on this run, an incremental dump is not possible
+    full_dump = full_dump_every < 2 || full_dump_file.empty() || incremental_dumps+1 >= full_dump_every;
+    
+    // With ranks_per_file, a group of ranks shares the file of its first rank, which aggregates the data
+    int file_rank = smpi->getRank();
+    bool aggregator = true;
+    if( ranks_per_file > 1 ) {
+        file_rank -= file_rank % ranks_per_file;
+        aggregator = ( file_rank == smpi->getRank() );
     }
     
-    nameDumpTmp << "dump-" << setfill( '0' ) << setw( 5 ) << num_dump << "-" << setfill( '0' ) << setw( 10 ) << smpi->getRank() << ".h5" ;
-    std::string dumpName=nameDumpTmp.str();
+    std::string dumpName = "checkpoints" PATH_SEPARATOR + dumpFileName( num_dump, file_rank, smpi->getSize(), file_grouping );
+    
+    // The previous dump must be on disk before its image is replaced
+    waitDump();
     
+    if( full_dump_every > 1 ) {
+        if( full_dump ) {
+            full_dump_hashes.clear();
+            full_dump_file = dumpName.substr( dumpName.find_last_of( PATH_SEPARATOR )+1 );
+            full_dump_slot = num_dump;
+            incremental_dumps = 0;
+        } else {
+            incremental_dumps++;
+        }
+    }
     
-    hid_t fid = H5Fcreate( dumpName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+    // In asynchronous mode, or when the data is sent to an aggregator,
+    // the file is built in memory (HDF5 core driver without backing store)
+    bool in_memory = dump_async || ! aggregator;
+    hid_t fapl = H5P_DEFAULT;
+    if( in_memory ) {
+        fapl = H5Pcreate( H5P_FILE_ACCESS );
+        H5Pset_fapl_core( fapl, 1<<24, 0 );
+    }
+    hid_t fid = H5Fcreate( dumpName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl );
+    if( in_memory ) {
+        H5Pclose( fapl );
+    }
     dump_number++;
     
 #ifdef  __DEBUG
-    MESSAGEALL( "Step " << itime << " : DUMP fields and particles " << dumpName );
+    MESSAGEALL( "Step " << itime << " : DUMP fields and particles " << dumpName << ( full_dump ? "" : " (incremental)" ) );
 #else
-    MESSAGE( "Step " << itime << " : DUMP fields and particles " << num_dump );
+    MESSAGE( "Step " << itime << " : DUMP fields and particles " << num_dump << ( full_dump ? "" : " (incremental)" ) );
 #endif
     
     
@@ -210,11 +292,20 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, unsigned int itime,  SmileiMP
     
     H5::attr( fid, "dump_step", itime );
     H5::attr( fid, "dump_number", dump_number );
+    if( ! full_dump ) {
+        H5::attr( fid, "full_dump_slot", full_dump_slot );
+    }
     
+    // patch_count and the file layout form the manifest giving the file of each patch (Hilbert index),
+    // used to restart on a different number of MPI processes
     H5::vect( fid, "patch_count", smpi->patch_count );
+    H5::attr( fid, "dump_slot", num_dump );
+    H5::attr( fid, "ranks_per_file", ranks_per_file );
+    H5::attr( fid, "file_grouping", file_grouping );
     
-    // Write diags scalar data
+    // Write diags scalar data, once their pending reduction is complete
     DiagnosticScalar *scalars = static_cast<DiagnosticScalar *>( vecPatches.globalDiags[0] );
+    scalars->finishReduction( true );
     H5::attr( fid, "latest_timestep",   scalars->latest_timestep );
     // Scalars only by master
     if( smpi->isMaster() ) {
@@ -256,32 +347,254 @@ void Checkpoint::dumpAll( VectorPatch &vecPatches, unsigned int itime,  SmileiMP
         
         dumpPatch( vecPatches( ipatch )->EMfields, vecPatches( ipatch )->vecSpecies, params, patch_gid );
         
-        // Random number generator state
-        H5::attr( patch_gid, "xorshift32_state", vecPatches( ipatch )->xorshift32_state );
-        
         // Close a group
         H5Gclose( patch_gid );
         
     }
     
     // Write the latest Id that the MPI processes have given to each species
+    // (in a group of its own when the file is shared by several ranks)
+    hid_t rank_gid = fid;
+    if( ranks_per_file > 1 ) {
+        ostringstream rank_name( "" );
+        rank_name << "rank-" << setfill( '0' ) << setw( 10 ) << smpi->getRank();
+        rank_gid = H5::group( fid, rank_name.str() );
+    }
     for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
         if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
             ostringstream n( "" );
             n<< "latest_ID_" << vecPatches( 0 )->vecSpecies[track->speciesId_]->name;
-            H5::attr( fid, n.str().c_str(), track->latest_Id, H5T_NATIVE_UINT64 );
+            H5::attr( rank_gid, n.str().c_str(), track->latest_Id, H5T_NATIVE_UINT64 );
         }
     }
+    if( rank_gid != fid ) {
+        H5Gclose( rank_gid );
+    }
     
     // Write the moving window status
     if( simWin!=NULL ) {
         dumpMovingWindow( fid, simWin );
     }
     
-    H5Fclose( fid );
+    if( ranks_per_file > 1 ) {
+        if( aggregator ) {
+            aggregateDumps( fid );
+        } else {
+            getDumpImage( fid, dumpName );
+            H5Fclose( fid );
+            sendDumpImage();
+            return;
+        }
+    }
+    
+    if( dump_async ) {
+        // Snapshot the in-memory file, then let a separate thread drain it to disk
+        getDumpImage( fid, dumpName );
+        H5Fclose( fid );
+        dump_writer = std::thread( &Checkpoint::writeDumpImage, this, dumpName );
+    } else {
+        H5Fclose( fid );
+    }
     
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Name of a dump file (relative to the checkpoints directory)
+// ---------------------------------------------------------------------------------------------------------------------
+std::string Checkpoint::dumpFileName( unsigned int num_dump, int file_rank, int nranks, unsigned int grouping )
+{
+    ostringstream nameDumpTmp( "" );
+    if( grouping>0 ) {
+        nameDumpTmp << setfill( '0' ) << setw( int( 1+log10( nranks/grouping+1 ) ) ) << file_rank/grouping << PATH_SEPARATOR;
+    }
+    nameDumpTmp << "dump-" << setfill( '0' ) << setw( 5 ) << num_dump << "-" << setfill( '0' ) << setw( 10 ) << file_rank << ".h5" ;
+    return nameDumpTmp.str();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Name of the dump file holding the data of the rank `rank` of the dumping run, using the manifest read in
+// readPatchDistribution (the files are looked for in the same checkpoints directory as restart_file)
+// ---------------------------------------------------------------------------------------------------------------------
+std::string Checkpoint::restartFileName( int rank )
+{
+    int file_rank = rank;
+    if( restart_ranks_per_file > 1 ) {
+        file_rank -= file_rank % restart_ranks_per_file;
+    }
+    string checkpoints_dir = "checkpoints" PATH_SEPARATOR;
+    size_t pos = restart_file.rfind( checkpoints_dir );
+    if( pos == string::npos ) {
+        ERROR( "Cannot restart on a different number of MPI processes from " << restart_file << ", which is not in a checkpoints directory" );
+    }
+    return restart_file.substr( 0, pos ) + checkpoints_dir
+           + dumpFileName( restart_slot, file_rank, restart_patch_count.size(), restart_file_grouping );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Copy the image of an in-memory dump file to dump_image
+// ---------------------------------------------------------------------------------------------------------------------
+void Checkpoint::getDumpImage( hid_t fid, std::string dumpName )
+{
+    H5Fflush( fid, H5F_SCOPE_GLOBAL );
+    ssize_t image_size = H5Fget_file_image( fid, NULL, 0 );
+    if( image_size < 0 ) {
+        ERROR( "Cannot get the image of the checkpoint file " << dumpName );
+    }
+    dump_image.resize( image_size );
+    H5Fget_file_image( fid, dump_image.data(), image_size );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Send dump_image to the aggregator of the group (by chunks, as the image may exceed the MPI count limit)
+// ---------------------------------------------------------------------------------------------------------------------
+static const size_t dump_chunk_size = 1<<30;
+
+void Checkpoint::sendDumpImage()
+{
+    uint64_t image_size = dump_image.size();
+    MPI_Send( &image_size, 1, MPI_UINT64_T, 0, SMILEI_COMM_DUMP_IMAGE, dump_comm );
+    for( size_t start=0; start<image_size; start+=dump_chunk_size ) {
+        int count = min( dump_chunk_size, image_size-start );
+        MPI_Send( &dump_image[start], count, MPI_BYTE, 0, SMILEI_COMM_DUMP_IMAGE, dump_comm );
+    }
+    std::vector<char>().swap( dump_image );
+}
+
+// Copy the patches and per-rank data from the dump of another rank to the shared file
+static herr_t copyDumpObject( hid_t src, const char *name, const H5L_info_t *, void *dst )
+{
+    if( strncmp( name, "patch-", 6 ) == 0 || strncmp( name, "rank-", 5 ) == 0 ) {
+        H5Ocopy( src, name, *( hid_t * )dst, name, H5P_DEFAULT, H5P_DEFAULT );
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Receive the dumps of the other ranks of the group, one at a time, and merge them in the shared file fid
+// Patch groups keep their Hilbert-index names, so that any rank can read its patches from the shared file
+// ---------------------------------------------------------------------------------------------------------------------
+void Checkpoint::aggregateDumps( hid_t fid )
+{
+    int group_size;
+    MPI_Comm_size( dump_comm, &group_size );
+    std::vector<char> image;
+    for( int irank=1; irank<group_size; irank++ ) {
+        uint64_t image_size;
+        MPI_Recv( &image_size, 1, MPI_UINT64_T, irank, SMILEI_COMM_DUMP_IMAGE, dump_comm, MPI_STATUS_IGNORE );
+        image.resize( image_size );
+        for( size_t start=0; start<image_size; start+=dump_chunk_size ) {
+            int count = min( dump_chunk_size, image_size-start );
+            MPI_Recv( &image[start], count, MPI_BYTE, irank, SMILEI_COMM_DUMP_IMAGE, dump_comm, MPI_STATUS_IGNORE );
+        }
+        
+        hid_t fapl = H5Pcreate( H5P_FILE_ACCESS );
+        H5Pset_fapl_core( fapl, 1<<24, 0 );
+        H5Pset_file_image( fapl, image.data(), image_size );
+        hid_t src = H5Fopen( "dump_image", H5F_ACC_RDONLY, fapl );
+        H5Pclose( fapl );
+        if( src < 0 ) {
+            ERROR( "Cannot open the checkpoint image received from rank " << irank << " of the file group" );
+        }
+        H5Literate( src, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, copyDumpObject, &fid );
+        H5Fclose( src );
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Write the image of a dump to disk (runs in the dump_writer thread)
+// The file is written under a temporary name then renamed, so that the previous dump with the
+// same number stays valid until the new one is complete
+// ---------------------------------------------------------------------------------------------------------------------
+void Checkpoint::writeDumpImage( std::string dumpName )
+{
+    string tmpName = dumpName + ".tmp";
+    FILE *f = fopen( tmpName.c_str(), "wb" );
+    if( f == NULL ) {
+        dump_writer_error = "Cannot open checkpoint file " + tmpName;
+        return;
+    }
+    size_t written = fwrite( dump_image.data(), 1, dump_image.size(), f );
+    if( fclose( f ) != 0 || written != dump_image.size() ) {
+        dump_writer_error = "Cannot write checkpoint file " + tmpName;
+        return;
+    }
+    if( rename( tmpName.c_str(), dumpName.c_str() ) != 0 ) {
+        dump_writer_error = "Cannot rename " + tmpName + " to " + dumpName;
+        return;
+    }
+    // Release the staging memory until the next dump
+    std::vector<char>().swap( dump_image );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Hash of a buffer (64-bit words mixed with the splitmix64 finalizer), used to detect unchanged datasets
+// ---------------------------------------------------------------------------------------------------------------------
+static uint64_t hashData( const void *data, size_t size )
+{
+    const char *bytes = static_cast<const char *>( data );
+    uint64_t h = size;
+    size_t nwords = size / sizeof( uint64_t );
+    for( size_t i=0; i<nwords; i++ ) {
+        uint64_t w;
+        memcpy( &w, bytes + i*sizeof( uint64_t ), sizeof( uint64_t ) );
+        h ^= w + 0x9e3779b97f4a7c15ULL + ( h<<6 ) + ( h>>2 );
+    }
+    uint64_t w = 0;
+    memcpy( &w, bytes + nwords*sizeof( uint64_t ), size - nwords*sizeof( uint64_t ) );
+    h ^= w;
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Full dumps record the hash of each dataset. Incremental dumps replace the datasets with the same hash
+// by external links to the full dump, which HDF5 follows transparently when restarting
+// ---------------------------------------------------------------------------------------------------------------------
+bool Checkpoint::linkToFullDump( hid_t gid, std::string name, const void *data, size_t size )
+{
+    if( full_dump_every < 2 || size == 0 ) {
+        return false;
+    }
+    
+    ssize_t length = H5Iget_name( gid, NULL, 0 );
+    string path( length, ' ' );
+    H5Iget_name( gid, &path[0], length+1 );
+    if( path != "/" ) {
+        path += "/";
+    }
+    path += name;
+    
+    uint64_t hash = hashData( data, size );
+    if( full_dump ) {
+        full_dump_hashes[path] = hash;
+        return false;
+    }
+    
+    map<string, uint64_t>::iterator it = full_dump_hashes.find( path );
+    if( it == full_dump_hashes.end() || it->second != hash ) {
+        return false;
+    }
+    H5Lcreate_external( full_dump_file.c_str(), path.c_str(), gid, name.c_str(), H5P_DEFAULT, H5P_DEFAULT );
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Wait for the asynchronous writing of the latest dump
+// ---------------------------------------------------------------------------------------------------------------------
+void Checkpoint::waitDump()
+{
+    if( dump_writer.joinable() ) {
+        dump_writer.join();
+        if( ! dump_writer_error.empty() ) {
+            ERROR( dump_writer_error );
+        }
+    }
+}
+
 void Checkpoint::dumpPatch( ElectroMagn *EMfields, std::vector<Species *> vecSpecies, Params &params, hid_t patch_gid )
 {
     if (  params.geometry != "AMcylindrical" ) {
@@ -416,25 +729,25 @@ void Checkpoint::dumpPatch( ElectroMagn *EMfields, std::vector<Species *> vecSpe
             for( unsigned int i=0; i<vecSpecies[ispec]->particles->Position.size(); i++ ) {
                 ostringstream my_name( "" );
                 my_name << "Position-" << i;
-                H5::vect( gid, my_name.str(), vecSpecies[ispec]->particles->Position[i], dump_deflate );
+                dumpVect( gid, my_name.str(), vecSpecies[ispec]->particles->Position[i], dump_deflate );
             }
             
             for( unsigned int i=0; i<vecSpecies[ispec]->particles->Momentum.size(); i++ ) {
                 ostringstream my_name( "" );
                 my_name << "Momentum-" << i;
-                H5::vect( gid, my_name.str(), vecSpecies[ispec]->particles->Momentum[i], dump_deflate );
+                dumpVect( gid, my_name.str(), vecSpecies[ispec]->particles->Momentum[i], dump_deflate );
             }
             
-            H5::vect( gid, "Weight", vecSpecies[ispec]->particles->Weight, dump_deflate );
-            H5::vect( gid, "Charge", vecSpecies[ispec]->particles->Charge, dump_deflate );
+            dumpVect( gid, "Weight", vecSpecies[ispec]->particles->Weight, dump_deflate );
+            dumpVect( gid, "Charge", vecSpecies[ispec]->particles->Charge, dump_deflate );
             
             if( vecSpecies[ispec]->particles->tracked ) {
-                H5::vect( gid, "Id", vecSpecies[ispec]->particles->Id, H5T_NATIVE_UINT64, dump_deflate );
+                dumpVect( gid, "Id", vecSpecies[ispec]->particles->Id, H5T_NATIVE_UINT64, dump_deflate );
             }
             
             
-            H5::vect( gid, "first_index", vecSpecies[ispec]->first_index );
-            H5::vect( gid, "last_index", vecSpecies[ispec]->last_index );
+            dumpVect( gid, "first_index", vecSpecies[ispec]->first_index );
+            dumpVect( gid, "last_index", vecSpecies[ispec]->last_index );
             
         } // End if partSize
         
@@ -444,9 +757,9 @@ void Checkpoint::dumpPatch( ElectroMagn *EMfields, std::vector<Species *> vecSpe
 };
 
 
-void Checkpoint::readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin )
+void Checkpoint::readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin, Params &params, DomainDecomposition *domain_decomposition )
 {
-    hid_t fid = H5Fopen( restart_file.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+    hid_t fid = H5Fopen( restart_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
     if( fid < 0 ) {
         ERROR( restart_file << " is not a valid HDF5 file" );
     }
@@ -463,14 +776,33 @@ void Checkpoint::readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin )
         WARNING( "                while running version is " << string( __VERSION ) );
     }
     
-    vector<int> patch_count( smpi->getSize() );
-    H5::getVect( fid, "patch_count", patch_count );
-    smpi->patch_count = patch_count;
+    // Read the manifest of the dump
+    restart_patch_count.resize( H5::getVectSize( fid, "patch_count" ) );
+    H5::getVect( fid, "patch_count", restart_patch_count );
+    restart_slot = 0;
+    restart_ranks_per_file = 0;
+    restart_file_grouping = file_grouping;
+    if( H5::hasAttr( fid, "dump_slot" ) ) {
+        H5::getAttr( fid, "dump_slot", restart_slot );
+        H5::getAttr( fid, "ranks_per_file", restart_ranks_per_file );
+        H5::getAttr( fid, "file_grouping", restart_file_grouping );
+    }
     
-    smpi->patch_refHindexes.resize( smpi->patch_count.size(), 0 );
-    smpi->patch_refHindexes[0] = 0;
-    for( int rk=1 ; rk<smpi->smilei_sz ; rk++ ) {
-        smpi->patch_refHindexes[rk] = smpi->patch_refHindexes[rk-1] + smpi->patch_count[rk-1];
+    if( restart_patch_count.size() == ( size_t )smpi->getSize() ) {
+        smpi->patch_count = restart_patch_count;
+        
+        smpi->patch_refHindexes.resize( smpi->patch_count.size(), 0 );
+        smpi->patch_refHindexes[0] = 0;
+        for( int rk=1 ; rk<smpi->smilei_sz ; rk++ ) {
+            smpi->patch_refHindexes[rk] = smpi->patch_refHindexes[rk-1] + smpi->patch_count[rk-1];
+        }
+    } else {
+        // Elastic restart: new balanced distribution, patches are read from the files of the dumping ranks
+        if( ! H5::hasAttr( fid, "dump_slot" ) ) {
+            ERROR( "The dump " << restart_file << " does not allow restarting on a different number of MPI processes" );
+        }
+        MESSAGE( 2, "Restarting on " << smpi->getSize() << " MPI processes from a dump of " << restart_patch_count.size() << " processes" );
+        smpi->init_patch_count( params, domain_decomposition );
     }
     
     // load window status : required to know the patch movement
@@ -484,7 +816,7 @@ void Checkpoint::restartAll( VectorPatch &vecPatches,  SmileiMPI *smpi, SimWindo
 {
     MESSAGE( 1, "READING fields and particles for restart" );
     
-    hid_t fid = H5Fopen( restart_file.c_str(), H5F_ACC_RDWR, H5P_DEFAULT );
+    hid_t fid = H5Fopen( restart_file.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
     if( fid < 0 ) {
         ERROR( restart_file << " is not a valid HDF5 file" );
     }
@@ -530,35 +862,84 @@ void Checkpoint::restartAll( VectorPatch &vecPatches,  SmileiMPI *smpi, SimWindo
         }
     }
     
+    // On a different number of MPI processes, the patches are read in the files of the dumping ranks
+    // which owned them, found from the manifest (files are kept open while consecutive patches share them)
+    bool elastic = restart_patch_count.size() != ( size_t )smpi->getSize();
+    vector<int> restart_refHindexes( restart_patch_count.size()+1, 0 );
+    for( unsigned int rk=0 ; rk<restart_patch_count.size() ; rk++ ) {
+        restart_refHindexes[rk+1] = restart_refHindexes[rk] + restart_patch_count[rk];
+    }
+    string patch_file_name = restart_file;
+    hid_t patch_fid = fid;
+    
     // Read all the patch data
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size(); ipatch++ ) {
     
+        if( elastic ) {
+            int rk = upper_bound( restart_refHindexes.begin(), restart_refHindexes.end(), ( int )vecPatches( ipatch )->Hindex() ) - restart_refHindexes.begin() - 1;
+            string name = restartFileName( rk );
+            if( name != patch_file_name ) {
+                if( patch_fid != fid ) {
+                    H5Fclose( patch_fid );
+                }
+                patch_file_name = name;
+                patch_fid = H5Fopen( patch_file_name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+                if( patch_fid < 0 ) {
+                    ERROR( patch_file_name << " is not a valid HDF5 file" );
+                }
+            }
+        }
+        
         ostringstream patch_name( "" );
         patch_name << setfill( '0' ) << setw( 6 ) << vecPatches( ipatch )->Hindex();
         string patchName=Tools::merge( "patch-", patch_name.str() );
-        hid_t patch_gid = H5Gopen( fid, patchName.c_str(), H5P_DEFAULT );
+        hid_t patch_gid = H5Gopen( patch_fid, patchName.c_str(), H5P_DEFAULT );
+        if( patch_gid < 0 ) {
+            ERROR( "Cannot find " << patchName << " in " << patch_file_name );
+        }
         
         restartPatch( vecPatches( ipatch )->EMfields, vecPatches( ipatch )->vecSpecies, params, patch_gid );
         
-        // Random number generator state
-        H5::getAttr( patch_gid, "xorshift32_state", vecPatches( ipatch )->xorshift32_state );
-        
         H5Gclose( patch_gid );
         
     }
+    if( patch_fid != fid ) {
+        H5Fclose( patch_fid );
+    }
     
     // Read the latest Id that the MPI processes have given to each species
+    // (in a group of its own when the file is shared by several ranks)
+    // On a different number of MPI processes, each rank continues the Ids of the dumping rank with the same
+    // number, and new ranks start their own range
+    hid_t rank_fid = fid;
+    if( elastic && ( size_t )smpi->getRank() < restart_patch_count.size() && restartFileName( smpi->getRank() ) != restart_file ) {
+        rank_fid = H5Fopen( restartFileName( smpi->getRank() ).c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+    }
+    hid_t rank_gid = rank_fid;
+    ostringstream rank_name( "" );
+    rank_name << "rank-" << setfill( '0' ) << setw( 10 ) << smpi->getRank();
+    if( H5Lexists( rank_fid, rank_name.str().c_str(), H5P_DEFAULT ) > 0 ) {
+        rank_gid = H5Gopen( rank_fid, rank_name.str().c_str(), H5P_DEFAULT );
+    }
     for( unsigned int idiag=0; idiag<vecPatches.localDiags.size(); idiag++ ) {
         if( DiagnosticTrack *track = dynamic_cast<DiagnosticTrack *>( vecPatches.localDiags[idiag] ) ) {
             ostringstream n( "" );
             n<< "latest_ID_" << vecPatches( 0 )->vecSpecies[track->speciesId_]->name;
-            if( H5::hasAttr( fid, n.str() ) ) {
-                H5::getAttr( fid, n.str(), track->latest_Id, H5T_NATIVE_UINT64 );
+            if( elastic && ( size_t )smpi->getRank() >= restart_patch_count.size() ) {
+                track->latest_Id = smpi->getRank() * 4294967296; // 2^32
+            } else if( H5::hasAttr( rank_gid, n.str() ) ) {
+                H5::getAttr( rank_gid, n.str(), track->latest_Id, H5T_NATIVE_UINT64 );
             } else {
                 track->IDs_done=false;
             }
         }
     }
+    if( rank_gid != rank_fid ) {
+        H5Gclose( rank_gid );
+    }
+    if( rank_fid != fid ) {
+        H5Fclose( rank_fid );
+    }
     
     H5Fclose( fid );
     
@@ -757,6 +1138,9 @@ void Checkpoint::restartPatch( ElectroMagn *EMfields, std::vector<Species *> &ve
 
 void Checkpoint::dumpFieldsPerProc( hid_t fid, Field *field )
 {
+    if( linkToFullDump( fid, field->name, &field->data_[0], field->globalDims_*sizeof( double ) ) ) {
+        return;
+    }
     hsize_t dims[1]= {field->globalDims_};
     hid_t sid = H5Screate_simple( 1, dims, NULL );
     hid_t did = H5Dcreate( fid, field->name.c_str(), H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
@@ -768,6 +1152,9 @@ void Checkpoint::dumpFieldsPerProc( hid_t fid, Field *field )
 void Checkpoint::dump_cFieldsPerProc( hid_t fid, Field *field )
 {
     cField *cfield = static_cast<cField *>( field );
+    if( linkToFullDump( fid, field->name, &cfield->cdata_[0], 2*field->globalDims_*sizeof( double ) ) ) {
+        return;
+    }
     hsize_t dims[1]= {2*field->globalDims_}; //*2 : to manage complex data
     hid_t sid = H5Screate_simple( 1, dims, NULL );
     hid_t did = H5Dcreate( fid, field->name.c_str(), H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
@@ -9,9 +9,13 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <thread>
+#include <cstdint>
 
 #include <hdf5.h>
 #include <Tools.h>
+#include "H5.h"
 
 class Params;
 class OpenPMDparams;
@@ -23,6 +27,7 @@ class Field;
 class cField;
 class Species;
 class VectorPatch;
+class DomainDecomposition;
 
 #include <csignal>
 
@@ -34,13 +39,14 @@ class Checkpoint
 public:
     Checkpoint( Params &params, SmileiMPI *smpi );
     //! Destructor for Checkpoint
-    virtual ~Checkpoint() {};
+    virtual ~Checkpoint();
     
     //! Space dimension of a particle
     unsigned int nDim_particle;
     
     //! restart everything to file per processor
-    void readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin );
+    //! (on a different number of MPI processes, a new distribution is computed)
+    void readPatchDistribution( SmileiMPI *smpi, SimWindow *simWin, Params &params, DomainDecomposition *domain_decomposition );
     void restartAll( VectorPatch &vecPatches,  SmileiMPI *smpi, SimWindow *simWin, Params &params, OpenPMDparams &openPMD );
     void restartPatch( ElectroMagn *EMfields, std::vector<Species *> &vecSpecies, Params &params, hid_t patch_gid );
     
@@ -60,6 +66,9 @@ public:
     void dumpAll( VectorPatch &vecPatches, unsigned int itime,  SmileiMPI *smpi, SimWindow *simWin, Params &params );
     void dumpPatch( ElectroMagn *EMfields, std::vector<Species *> vecSpecies, Params &params, hid_t patch_gid );
     
+    //! wait until the asynchronous writing of the latest dump is complete
+    void waitDump();
+    
     //! incremental number of times we've done a dump
     unsigned int dump_number;
     
@@ -108,6 +117,44 @@ private:
     //! dump moving window parameters
     void dumpMovingWindow( hid_t fid, SimWindow *simWindow );
     
+    //! write dump_image to the file dumpName (body of dump_writer)
+    void writeDumpImage( std::string dumpName );
+    
+    //! name of a dump file, relative to the checkpoints directory
+    std::string dumpFileName( unsigned int num_dump, int file_rank, int nranks, unsigned int grouping );
+    
+    //! name of the restart file which holds the data of a given rank of the dumping run
+    std::string restartFileName( int rank );
+    
+    //! copy the image of the in-memory file fid to dump_image
+    void getDumpImage( hid_t fid, std::string dumpName );
+    
+    //! send dump_image to the aggregator of the file group
+    void sendDumpImage();
+    
+    //! merge the dumps received from the other ranks of the file group into the shared file fid
+    void aggregateDumps( hid_t fid );
+    
+    //! in an incremental dump, replace the dataset `name` of the group gid by a link to the latest
+    //! full dump when its data did not change since then (returns true if the link was created)
+    bool linkToFullDump( hid_t gid, std::string name, const void *data, size_t size );
+    
+    //! write a vector, or a link to the latest full dump if it did not change since then
+    template<class V>
+    void dumpVect( hid_t gid, std::string name, V &v, int deflate=0 )
+    {
+        if( ! linkToFullDump( gid, name, v.data(), v.size()*sizeof( v[0] ) ) ) {
+            H5::vect( gid, name, v, deflate );
+        }
+    }
+    template<class V>
+    void dumpVect( hid_t gid, std::string name, V &v, hid_t type, int deflate=0 )
+    {
+        if( ! linkToFullDump( gid, name, v.data(), v.size()*sizeof( v[0] ) ) ) {
+            H5::vect( gid, name, v, type, deflate );
+        }
+    }
+    
     //! function that returns elapsed time from creator (uses private var time_reference)
     //double time_seconds();
     
@@ -131,6 +178,36 @@ private:
     //! int deflate dump value
     int dump_deflate;
     
+    //! write the dump files in a background thread
+    bool dump_async;
+    
+    //! in-memory image of the latest dump, drained to disk by dump_writer
+    std::vector<char> dump_image;
+    
+    //! thread writing dump_image to disk
+    std::thread dump_writer;
+    
+    //! error message set by dump_writer when the write failed
+    std::string dump_writer_error;
+    
+    //! one dump out of full_dump_every is full, the others only store the data changed since the latest full dump
+    unsigned int full_dump_every;
+    
+    //! true while writing a full dump
+    bool full_dump;
+    
+    //! number of incremental dumps written since the latest full dump
+    unsigned int incremental_dumps;
+    
+    //! file name (without directory) of the latest full dump
+    std::string full_dump_file;
+    
+    //! dump number (in the keep_n_dumps rotation) of the latest full dump, which must not be overwritten
+    int full_dump_slot;
+    
+    //! hash of each dataset of the latest full dump, indexed by path in the file
+    std::map<std::string, uint64_t> full_dump_hashes;
+    
     std::vector<MPI_Request> dump_request;
     MPI_Status dump_status_prob;
     MPI_Status dump_status_recv;
@@ -138,9 +215,21 @@ private:
     //! group checkpoint files in subdirs of file_grouping files
     unsigned int file_grouping;
     
+    //! number of ranks sharing a checkpoint file (the first rank of each group writes the file)
+    unsigned int ranks_per_file;
+    
+    //! communicator of the ranks sharing a checkpoint file
+    MPI_Comm dump_comm;
+    
     //! restart file
     std::string restart_file;
     
+    //! manifest of the restart dump: patch count of each dumping rank and layout of the files
+    std::vector<int> restart_patch_count;
+    unsigned int restart_slot;
+    unsigned int restart_ranks_per_file;
+    unsigned int restart_file_grouping;
+    
 };
 
 #endif /* CHECKPOINT_H_ */
@@ -224,6 +224,15 @@ void CollisionalIonization::prepare3( double timestep, double inv_cell_volume )
 
 // Method to apply the ionization
 void CollisionalIonization::apply( Patch *patch, Particles *p1, int i1, Particles *p2, int i2 )
+{
+    // Random numbers
+    double U1  = patch->rand_->uniform();
+    double U2  = patch->rand_->uniform();
+    apply( p1, i1, p2, i2, U1, U2 );
+}
+
+// Method to apply the ionization, with random numbers U1 and U2 already picked
+void CollisionalIonization::apply( Particles *p1, int i1, Particles *p2, int i2, double U1, double U2 )
 {
     double gamma1 = p1->lor_fac( i1 );
     double gamma2 = p2->lor_fac( i2 );
@@ -232,9 +241,6 @@ void CollisionalIonization::apply( Patch *patch, Particles *p1, int i1, Particle
                      - p1->momentum( 0, i1 )*p2->momentum( 0, i2 )
                      - p1->momentum( 1, i1 )*p2->momentum( 1, i2 )
                      - p1->momentum( 2, i1 )*p2->momentum( 2, i2 );
-    // Random numbers
-    double U1  = patch->xorshift32() * patch->xorshift32_invmax;
-    double U2  = patch->xorshift32() * patch->xorshift32_invmax;
     // Calculate the rest of the stuff
     if( electronFirst ) {
         calculate( gamma_s, gamma1, gamma2, p1, i1, p2, i2, U1, U2 );
@@ -45,6 +45,13 @@ public:
     virtual void prepare3( double, double );
     //! Method to apply the ionization
     virtual void apply( Patch *patch, Particles *p1, int i1, Particles *p2, int i2 );
+    //! Method to apply the ionization, with random numbers U1 and U2 already picked
+    virtual void apply( Particles *p1, int i1, Particles *p2, int i2, double U1, double U2 );
+    //! False if no ionization is done (no random numbers are needed by apply)
+    virtual bool is_active()
+    {
+        return true;
+    };
     //! Method to finish the ionization and put new electrons in place
     virtual void finish( Params &, Patch *, std::vector<Diagnostic *> & );
     
@@ -119,6 +126,11 @@ public:
     void prepare2( Particles *, int, Particles *, int, bool ) override {};
     void prepare3( double, double ) override {};
     void apply( Patch *, Particles *, int, Particles *, int ) override {};
+    void apply( Particles *, int, Particles *, int, double, double ) override {};
+    bool is_active() override
+    {
+        return false;
+    };
     //void finish(Species*, Species*, Params&, Patch*) override {};
     void finish( Params &, Patch *, std::vector<Diagnostic *> & ) override {};
 };
@@ -162,7 +162,7 @@ void Collisions::calculate_debye_length( Params &params, Patch *patch )
 }
 
 // Calculates the collisions for a given Collisions object
-void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
+void Collisions::collide( Params &params, SmileiMPI *smpi, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
 {
 
     vector<unsigned int> *sg1, *sg2, index1, index2;
@@ -174,17 +174,20 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
     unsigned int i1=0, i2, ispec1, ispec2, N2max;
     Species   *s1, *s2;
     Particles *p1=NULL, *p2;
-    double m12, coeff3, coeff4, logL, s, ncol, debye2=0.;
+    double coeff3, coeff4, ncol=0., debye2=0.;
     bool not_duplicated_particle;
     
     sg1 = &species_group1_;
     sg2 = &species_group2_;
     
+    // Thread buffers for the blocks of pairs
+    double *buffer;
+    unsigned int *pairs;
+    get_block_buffers( smpi, buffer, pairs );
     
     bool debug = ( debug_every_ > 0 && itime % debug_every_ == 0 ); // debug only every N timesteps
     
     if( debug ) {
-        ncol = 0.;
         smean_       = 0.;
         logLmean_    = 0.;
         //temperature = 0.;
@@ -238,7 +241,7 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
         }
         // shuffle the index array
         for( unsigned int i=npart1; i>1; i-- ) {
-            unsigned int p = patch->xorshift32() % i;
+            unsigned int p = patch->rand_->integer() % i;
             swap( index1[i-1], index1[p] );
         }
         if( intra_collisions_ ) { // In the case of collisions within one species
@@ -314,48 +317,31 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
         // Prepare the ionization
         Ionization->prepare3( params.timestep, inv_cell_volume );
         
-        // Now start the real loop on pairs of particles
-        // See equations in http://dx.doi.org/10.1063/1.4742167
+        // Now start the real loop on pairs of particles, by blocks of different particles
+        // (a particle of group 2 is found again N2max pairs later)
         // ----------------------------------------------------
-        for( unsigned int i=0; i<npairs; i++ ) {
-        
-            // find species and index i1 of particle "1"
-            i1 = index1[i];
-            for( ispec1=0 ; i1>=np1[ispec1]; ispec1++ ) {
-                i1 -= np1[ispec1];
+        unsigned int block_size = min( N2max, max_block_size_ );
+        for( unsigned int iblock=0; iblock<npairs; iblock+=block_size ) {
+            unsigned int nblock = min( block_size, npairs-iblock );
+            for( unsigned int k=0; k<nblock; k++ ) {
+                // find species and index i1 of particle "1"
+                i1 = index1[iblock+k];
+                for( ispec1=0 ; i1>=np1[ispec1]; ispec1++ ) {
+                    i1 -= np1[ispec1];
+                }
+                // find species and index i2 of particle "2"
+                i2 = index2[iblock+k];
+                for( ispec2=0 ; i2>=np2[ispec2]; ispec2++ ) {
+                    i2 -= np2[ispec2];
+                }
+                
+                pairs[4*k  ] = ( *sg1 )[ispec1];
+                pairs[4*k+1] = i1 + patch->vecSpecies[( *sg1 )[ispec1]]->first_index[ibin];
+                pairs[4*k+2] = ( *sg2 )[ispec2];
+                pairs[4*k+3] = i2 + patch->vecSpecies[( *sg2 )[ispec2]]->first_index[ibin];
             }
-            // find species and index i2 of particle "2"
-            i2 = index2[i];
-            for( ispec2=0 ; i2>=np2[ispec2]; ispec2++ ) {
-                i2 -= np2[ispec2];
-            }
-            
-            s1 = patch->vecSpecies[( *sg1 )[ispec1]];
-            s2 = patch->vecSpecies[( *sg2 )[ispec2]];
-            i1 += s1->first_index[ibin];
-            i2 += s2->first_index[ibin];
-            p1 = s1->particles;
-            p2 = s2->particles;
-            
-            m12  = s1->mass / s2->mass; // mass ratio
-            
-            logL = coulomb_log_;
-            double U1  = patch->xorshift32() * patch->xorshift32_invmax;
-            double U2  = patch->xorshift32() * patch->xorshift32_invmax;
-            double phi = patch->xorshift32() * patch->xorshift32_invmax * twoPi;
-            s = one_collision( p1, i1, s1->mass, p2, i2, m12, coeff1_, coeff2_, coeff3, coeff4, n123, n223, debye2, logL, U1, U2, phi );
-            
-            // Handle ionization
-            Ionization->apply( patch, p1, i1, p2, i2 );
-            
-            if( debug ) {
-                ncol     += 1;
-                smean_    += s;
-                logLmean_ += logL;
-                //temperature += m1 * (sqrt(1.+pow(p1->momentum(0,i1),2)+pow(p1->momentum(1,i1),2)+pow(p1->momentum(2,i1),2))-1.);
-            }
-            
-        } // end loop on pairs of particles
+            collide_block( patch, buffer, pairs, nblock, coeff3, coeff4, n123, n223, debye2, debug, ncol );
+        } // end loop on blocks of pairs of particles
         
     } // end loop on bins
     
@@ -369,6 +355,254 @@ void Collisions::collide( Params &params, Patch *patch, int itime, vector<Diagno
 }
 
 
+// Get the thread buffers used by collide_block
+void Collisions::get_block_buffers( SmileiMPI *smpi, double *&buffer, unsigned int *&pairs )
+{
+    int ithread;
+#ifdef _OPENMP
+    ithread = omp_get_thread_num();
+#else
+    ithread = 0;
+#endif
+    smpi->collisions_buffer[ithread].resize( n_block_arrays_*max_block_size_ );
+    smpi->collisions_pairs[ithread].resize( 4*max_block_size_ );
+    buffer = &( smpi->collisions_buffer[ithread][0] );
+    pairs  = &( smpi->collisions_pairs[ithread][0] );
+}
+
+
+// Collide a block of pairs of particles
+//   1 - the particles and the random numbers of each pair are gathered in contiguous arrays
+//   2 - the collisions are calculated in SIMD lanes, see equations in http://dx.doi.org/10.1063/1.4742167
+//   3 - the new momenta are scattered back to the particles, then the ionization is applied pair by pair
+// The random numbers are picked in the same order as when the pairs are treated one after the other.
+void Collisions::collide_block(
+    Patch *patch,
+    double *buffer,
+    unsigned int *pairs,
+    unsigned int npairs,
+    double coeff3,
+    double coeff4,
+    double n123,
+    double n223,
+    double debye2,
+    bool debug,
+    double &ncol
+)
+{
+    const unsigned int B = max_block_size_;
+    double *__restrict__ px1  = &buffer[ 0*B];
+    double *__restrict__ py1  = &buffer[ 1*B];
+    double *__restrict__ pz1  = &buffer[ 2*B];
+    double *__restrict__ W1   = &buffer[ 3*B];
+    double *__restrict__ q1   = &buffer[ 4*B];
+    double *__restrict__ m1   = &buffer[ 5*B];
+    double *__restrict__ px2  = &buffer[ 6*B];
+    double *__restrict__ py2  = &buffer[ 7*B];
+    double *__restrict__ pz2  = &buffer[ 8*B];
+    double *__restrict__ W2   = &buffer[ 9*B];
+    double *__restrict__ q2   = &buffer[10*B];
+    double *__restrict__ m12  = &buffer[11*B];
+    double *__restrict__ U1   = &buffer[12*B];
+    double *__restrict__ U2   = &buffer[13*B];
+    double *__restrict__ phi  = &buffer[14*B];
+    double *__restrict__ Ui1  = &buffer[15*B];
+    double *__restrict__ Ui2  = &buffer[16*B];
+    double *__restrict__ s    = &buffer[17*B];
+    double *__restrict__ logL = &buffer[18*B];
+    
+    bool ionization = Ionization->is_active();
+    
+    // Gather the pairs
+    for( unsigned int k=0; k<npairs; k++ ) {
+        Species *s1 = patch->vecSpecies[pairs[4*k  ]];
+        Species *s2 = patch->vecSpecies[pairs[4*k+2]];
+        Particles *p1 = s1->particles;
+        Particles *p2 = s2->particles;
+        unsigned int i1 = pairs[4*k+1];
+        unsigned int i2 = pairs[4*k+3];
+        px1[k] = p1->momentum( 0, i1 );
+        py1[k] = p1->momentum( 1, i1 );
+        pz1[k] = p1->momentum( 2, i1 );
+        W1 [k] = p1->weight( i1 );
+        q1 [k] = p1->charge( i1 );
+        m1 [k] = s1->mass;
+        px2[k] = p2->momentum( 0, i2 );
+        py2[k] = p2->momentum( 1, i2 );
+        pz2[k] = p2->momentum( 2, i2 );
+        W2 [k] = p2->weight( i2 );
+        q2 [k] = p2->charge( i2 );
+        m12[k] = s1->mass / s2->mass; // mass ratio
+        U1 [k] = patch->rand_->uniform();
+        U2 [k] = patch->rand_->uniform();
+        phi[k] = patch->rand_->uniform() * twoPi;
+        if( ionization ) {
+            Ui1[k] = patch->rand_->uniform();
+            Ui2[k] = patch->rand_->uniform();
+        }
+    }
+    
+    // Collide each pair
+    const double coeff1 = coeff1_, coeff2 = coeff2_, coulomb_log = coulomb_log_;
+    #pragma omp simd
+    for( unsigned int k=0; k<npairs; k++ ) {
+        double COM_gamma, term1, term2, px_COM, py_COM, pz_COM, gamma1_COM, gamma2_COM,
+               newpx_COM, newpy_COM, newpz_COM, cosX;
+               
+        // Calculate stuff
+        double qqm  = q1[k] * q2[k] / m1[k];
+        double qqm2 = qqm * qqm;
+        
+        // Calculate gammas
+        double gamma1 = sqrt( 1. + px1[k]*px1[k] + py1[k]*py1[k] + pz1[k]*pz1[k] );
+        double gamma2 = sqrt( 1. + px2[k]*px2[k] + py2[k]*py2[k] + pz2[k]*pz2[k] );
+        double gamma12_inv = 1./( m12[k] * gamma1 + gamma2 );
+        
+        // Calculate the center-of-mass (COM) frame
+        // Quantities starting with "COM" are those of the COM itself, expressed in the lab frame.
+        // They are NOT quantities relative to the COM.
+        double COM_vx = ( m12[k] * px1[k] + px2[k] ) * gamma12_inv;
+        double COM_vy = ( m12[k] * py1[k] + py2[k] ) * gamma12_inv;
+        double COM_vz = ( m12[k] * pz1[k] + pz2[k] ) * gamma12_inv;
+        double COM_vsquare = COM_vx*COM_vx + COM_vy*COM_vy + COM_vz*COM_vz;
+        
+        // Change the momentum to the COM frame (we work only on particle 1)
+        // Quantities ending with "COM" are quantities of the particle expressed in the COM frame.
+        if( COM_vsquare != 0. ) {
+            COM_gamma = 1./sqrt( 1.-COM_vsquare );
+            term1 = ( COM_gamma - 1. ) / COM_vsquare;
+            double vcv1  = ( COM_vx*px1[k] + COM_vy*py1[k] + COM_vz*pz1[k] )/gamma1;
+            double vcv2  = ( COM_vx*px2[k] + COM_vy*py2[k] + COM_vz*pz2[k] )/gamma2;
+            term2 = ( term1*vcv1 - COM_gamma ) * gamma1;
+            px_COM = px1[k] + term2*COM_vx;
+            py_COM = py1[k] + term2*COM_vy;
+            pz_COM = pz1[k] + term2*COM_vz;
+            gamma1_COM = ( 1.-vcv1 )*COM_gamma*gamma1;
+            gamma2_COM = ( 1.-vcv2 )*COM_gamma*gamma2;
+        } else {
+            COM_gamma = 1.;
+            term1 = 0.5;
+            term2 = gamma1;
+            px_COM = px1[k];
+            py_COM = py1[k];
+            pz_COM = pz1[k];
+            gamma1_COM = gamma1;
+            gamma2_COM = gamma2;
+        }
+        double p2_COM = px_COM*px_COM + py_COM*py_COM + pz_COM*pz_COM;
+        double p_COM  = sqrt( p2_COM );
+        
+        // Calculate some intermediate quantities
+        double term3 = COM_gamma * gamma12_inv;
+        double term4 = gamma1_COM * gamma2_COM;
+        double term5 = term4/p2_COM + m12[k];
+        
+        // Calculate coulomb log if necessary
+        double logLk = coulomb_log;
+        if( logLk <= 0. ) { // if auto-calculation requested
+            double bmin = std::max( coeff1/m1[k]/p_COM, std::abs( coeff2*qqm*term3*term5 ) ); // min impact parameter
+            logLk = 0.5*log( 1.+debye2/( bmin*bmin ) );
+            if( logLk < 2. ) {
+                logLk = 2.;
+            }
+        }
+        
+        // Calculate the collision parameter s12 (similar to number of real collisions)
+        double sk = coeff3 * logLk * qqm2 * term3 * p_COM * term5*term5 / ( gamma1*gamma2 );
+        
+        // Low-temperature correction
+        double vrel = p_COM/term3/term4; // relative velocity
+        double smax = coeff4 * ( m12[k]+1. ) * vrel / std::max( m12[k]*n123, n223 );
+        if( sk>smax ) {
+            sk = smax;
+        }
+        
+        // Pick the deflection angles
+        // Technique given by Nanbu in http://dx.doi.org/10.1103/PhysRevE.55.4642
+        //   to pick randomly the deflection angle cosine, in the center-of-mass frame.
+        // Technique slightly modified in http://dx.doi.org/10.1063/1.4742167
+        double U = U1[k];
+        if( sk < 0.1 ) {
+            if( U<0.0001 ) {
+                U=0.0001;    // ensures cos_chi > 0
+            }
+            cosX = 1. + sk*log( U );
+        } else if( sk < 3. ) {
+            // the polynomial has been modified from the article in order to have a better form
+            double invA = 0.00569578 +( 0.95602 + ( -0.508139 + ( 0.479139 + ( -0.12789 + 0.0238957*sk )*sk )*sk )*sk )*sk;
+            double A = 1./invA;
+            cosX = invA  * log( exp( -A ) + 2.*U*sinh( A ) );
+        } else if( sk < 6. ) {
+            double A = 3.*exp( -sk );
+            cosX = ( 1./A ) * log( exp( -A ) + 2.*U*sinh( A ) );
+        } else {
+            cosX = 2.*U - 1.;
+        }
+        double sinX = sqrt( 1. - cosX*cosX );
+        
+        // Calculate combination of angles
+        double sinXcosPhi = sinX*cos( phi[k] );
+        double sinXsinPhi = sinX*sin( phi[k] );
+        
+        // Apply the deflection
+        double p_perp = sqrt( px_COM*px_COM + py_COM*py_COM );
+        if( p_perp > 1.e-10*p_COM ) { // make sure p_perp is not too small
+            double inv_p_perp = 1./p_perp;
+            newpx_COM = ( px_COM * pz_COM * sinXcosPhi - py_COM * p_COM * sinXsinPhi ) * inv_p_perp + px_COM * cosX;
+            newpy_COM = ( py_COM * pz_COM * sinXcosPhi + px_COM * p_COM * sinXsinPhi ) * inv_p_perp + py_COM * cosX;
+            newpz_COM = -p_perp * sinXcosPhi  +  pz_COM * cosX;
+        } else { // if p_perp is too small, we use the limit px->0, py=0
+            newpx_COM = p_COM * sinXcosPhi;
+            newpy_COM = p_COM * sinXsinPhi;
+            newpz_COM = p_COM * cosX;
+        }
+        
+        // Go back to the lab frame
+        double vcp = COM_vx * newpx_COM + COM_vy * newpy_COM + COM_vz * newpz_COM;
+        if( U2[k] < W2[k]/W1[k] ) { // deflect particle 1 only with some probability
+            double term6 = term1*vcp + gamma1_COM * COM_gamma;
+            px1[k] = newpx_COM + COM_vx * term6;
+            py1[k] = newpy_COM + COM_vy * term6;
+            pz1[k] = newpz_COM + COM_vz * term6;
+        }
+        if( U2[k] < W1[k]/W2[k] ) { // deflect particle 2 only with some probability
+            double term6 = -m12[k] * term1*vcp + gamma2_COM * COM_gamma;
+            px2[k] = -m12[k] * newpx_COM + COM_vx * term6;
+            py2[k] = -m12[k] * newpy_COM + COM_vy * term6;
+            pz2[k] = -m12[k] * newpz_COM + COM_vz * term6;
+        }
+        
+        s   [k] = sk;
+        logL[k] = logLk;
+    }
+    
+    // Scatter the new momenta, and handle ionization
+    for( unsigned int k=0; k<npairs; k++ ) {
+        Particles *p1 = patch->vecSpecies[pairs[4*k  ]]->particles;
+        Particles *p2 = patch->vecSpecies[pairs[4*k+2]]->particles;
+        unsigned int i1 = pairs[4*k+1];
+        unsigned int i2 = pairs[4*k+3];
+        p1->momentum( 0, i1 ) = px1[k];
+        p1->momentum( 1, i1 ) = py1[k];
+        p1->momentum( 2, i1 ) = pz1[k];
+        p2->momentum( 0, i2 ) = px2[k];
+        p2->momentum( 1, i2 ) = py2[k];
+        p2->momentum( 2, i2 ) = pz2[k];
+        if( ionization ) {
+            Ionization->apply( p1, i1, p2, i2, Ui1[k], Ui2[k] );
+        }
+    }
+    
+    if( debug ) {
+        for( unsigned int k=0; k<npairs; k++ ) {
+            ncol      += 1;
+            smean_    += s[k];
+            logLmean_ += logL[k];
+        }
+    }
+}
+
+
 void Collisions::debug( Params &params, int itime, unsigned int icoll, VectorPatch &vecPatches )
 {
 
@@ -19,7 +19,7 @@ using namespace std;
 // The difference with Collisions::collide is that this version
 // does not handle more than 1 species on each side,
 // but is potentially faster
-void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
+void CollisionsSingle::collide( Params &params, SmileiMPI *smpi, Patch *patch, int itime, vector<Diagnostic *> &localDiags )
 {
 
     vector<unsigned int> index1;
@@ -27,17 +27,24 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
     unsigned int np1, np2; // numbers of macro-particles in each species
     double n1, n2, n12, n123, n223; // densities of particles
     unsigned int i1=0, i2, N2max, first_index1, first_index2;
+    unsigned int ispec1, ispec2;
     Species   *s1, *s2;
     Particles *p1=NULL, *p2;
-    double m12, coeff3, coeff4, logL, s, ncol, debye2=0.;
+    double coeff3, coeff4, ncol=0., debye2=0.;
     
-    s1 = patch->vecSpecies[species_group1_[0]];
-    s2 = patch->vecSpecies[species_group2_[0]];
+    ispec1 = species_group1_[0];
+    ispec2 = species_group2_[0];
+    s1 = patch->vecSpecies[ispec1];
+    s2 = patch->vecSpecies[ispec2];
+    
+    // Thread buffers for the blocks of pairs
+    double *buffer;
+    unsigned int *pairs;
+    get_block_buffers( smpi, buffer, pairs );
     
     bool debug = ( debug_every_ > 0 && itime % debug_every_ == 0 ); // debug only every N timesteps
     
     if( debug ) {
-        ncol = 0.;
         smean_       = 0.;
         logLmean_    = 0.;
         //temperature = 0.;
@@ -57,6 +64,7 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
         // Ensure species 1 has more macro-particles
         if( np2 > np1 ) {
             swap( s1, s2 );
+            swap( ispec1, ispec2 );
             swap( np1, np2 );
         }
         first_index1 = s1->first_index[ibin];
@@ -87,7 +95,7 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
             index1[i] = first_index1 + i;
         }
         for( unsigned int i=npairs; i>1; i-- ) {
-            unsigned int p = patch->xorshift32() % i;
+            unsigned int p = patch->rand_->integer() % i;
             swap( index1[i-1], index1[p] );
         }
         p1->swap_parts( index1 ); // exchange particles along the cycle defined by the shuffle
@@ -126,35 +134,24 @@ void CollisionsSingle::collide( Params &params, Patch *patch, int itime, vector<
         coeff3 = params.timestep * n1*n2/n12;
         coeff4 = pow( 3.*coeff2_, -1./3. ) * coeff3;
         coeff3 *= coeff2_;
-        m12  = s1->mass / s2->mass; // mass ratio
         
         // Prepare the ionization
         Ionization->prepare3( params.timestep, inv_cell_volume );
         
-        // Now start the real loop on pairs of particles
+        // Now start the real loop on pairs of particles, by blocks of different particles
+        // (a particle of species 2 is found again N2max pairs later)
         // ----------------------------------------------------
-        for( unsigned int i=0; i<npairs; i++ ) {
-            i1 = first_index1 + i;
-            i2 = first_index2 + i%N2max;
-            
-            logL = coulomb_log_;
-            double U1  = patch->xorshift32() * patch->xorshift32_invmax;
-            double U2  = patch->xorshift32() * patch->xorshift32_invmax;
-            double phi = patch->xorshift32() * patch->xorshift32_invmax * twoPi;
-            
-            s = one_collision( p1, i1, s1->mass, p2, i2, m12, coeff1_, coeff2_, coeff3, coeff4, n123, n223, debye2, logL, U1, U2, phi );
-            
-            // Handle ionization
-            Ionization->apply( patch, p1, i1, p2, i2 );
-            
-            if( debug ) {
-                ncol     += 1;
-                smean_    += s;
-                logLmean_ += logL;
-                //temperature += m1 * (sqrt(1.+pow(p1->momentum(0,i1),2)+pow(p1->momentum(1,i1),2)+pow(p1->momentum(2,i1),2))-1.);
+        unsigned int block_size = min( N2max, max_block_size_ );
+        for( unsigned int iblock=0; iblock<npairs; iblock+=block_size ) {
+            unsigned int nblock = min( block_size, npairs-iblock );
+            for( unsigned int k=0; k<nblock; k++ ) {
+                pairs[4*k  ] = ispec1;
+                pairs[4*k+1] = first_index1 + iblock+k;
+                pairs[4*k+2] = ispec2;
+                pairs[4*k+3] = first_index2 + ( iblock+k )%N2max;
             }
-            
-        } // end loop on pairs of particles
+            collide_block( patch, buffer, pairs, nblock, coeff3, coeff4, n123, n223, debye2, debug, ncol );
+        } // end loop on blocks of pairs of particles
         
     } // end loop on bins
     
@@ -49,7 +49,7 @@ public:
     ~CollisionsSingle() {};
     
     //! Method called in the main smilei loop to apply collisions at each timestep
-    void collide( Params &, Patch *, int, std::vector<Diagnostic *> & ) override;
+    void collide( Params &, SmileiMPI *, Patch *, int, std::vector<Diagnostic *> & ) override;
     
 };
 
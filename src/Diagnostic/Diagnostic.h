@@ -34,6 +34,9 @@ public :
     //! Runs the diag for a given patch for global diags.
     virtual void run( Patch *patch, int timestep, SimWindow *simWindow ) {};
     
+    //! Merges the data accumulated separately by each thread in run(). Called by all threads for global diags.
+    virtual void mergeThreads() {};
+    
     //! Runs the diag for all patches for local diags.
     virtual void run( SmileiMPI *smpi, VectorPatch &vecPatches, int timestep, SimWindow *simWindow, Timers &timers ) {};
     
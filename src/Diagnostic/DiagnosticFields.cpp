@@ -1,5 +1,6 @@
 
 #include <string>
+#include <cmath>
 
 #include "DiagnosticFields.h"
 #include "VectorPatch.h"
@@ -146,6 +147,36 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
     // Extract the flush time selection
     flush_timeSelection = new TimeSelection( PyTools::extract_py( "flush_every", "DiagFields", ndiag ), "DiagFields flush_every" );
     
+    // Extract the chunking and compression of the datasets
+    chunks_.resize( 0 );
+    vector<PyObject *> py_chunks = PyTools::extract_pyVec( "chunks", "DiagFields", ndiag );
+    if( py_chunks.size() > 0 && ! PyTools::convert( py_chunks, chunks_ ) ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<" `chunks` must be a list of integers" );
+    }
+    deflate_ = 0;
+    PyTools::extract( "deflate", deflate_, "DiagFields", ndiag );
+    if( deflate_ < 0 || deflate_ > 9 ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<" `deflate` must be between 0 and 9" );
+    }
+    shuffle_ = true;
+    PyTools::extract( "shuffle", shuffle_, "DiagFields", ndiag );
+    
+    // Extract the lossy reductions
+    string datatype = "double";
+    PyTools::extract( "datatype", datatype, "DiagFields", ndiag );
+    if( datatype == "double" ) {
+        datatype_ = H5T_NATIVE_DOUBLE;
+    } else if( datatype == "float" ) {
+        datatype_ = H5T_NATIVE_FLOAT;
+    } else {
+        ERROR( "Diagnostic Fields #"<<ndiag<<" `datatype` must be \"double\" or \"float\"" );
+    }
+    error_bound_ = 0.;
+    PyTools::extract( "error_bound", error_bound_, "DiagFields", ndiag );
+    if( error_bound_ < 0. ) {
+        ERROR( "Diagnostic Fields #"<<ndiag<<" `error_bound` must be positive" );
+    }
+    
     // Copy the total number of patches
     tot_number_of_patches = params.tot_number_of_patches;
     
@@ -175,6 +206,7 @@ DiagnosticFields::DiagnosticFields( Params &params, SmileiMPI *smpi, VectorPatch
 
 DiagnosticFields::~DiagnosticFields()
 {
+    joinWriter();
     H5Pclose( write_plist );
     H5Pclose( dcreate );
     
@@ -335,7 +367,9 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     
     unsigned int nPatches( vecPatches.size() );
     
-    // For each field, combine all patches and write out
+    // For each field, combine all patches and write out.
+    // The writing of a field is done by the field_writer thread while
+    // the OpenMP threads gather the next field in the other buffer.
     for( unsigned int ifield=0; ifield < fields_indexes.size(); ifield++ ) {
     
         // Copy the patch field to the buffer
@@ -347,25 +381,17 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         
         #pragma omp master
         {
-            // Create field dataset in HDF5
-            hid_t dset_id  = H5Dcreate( iteration_group_id, fields_names[ifield].c_str(), H5T_NATIVE_DOUBLE, filespace, H5P_DEFAULT, dcreate, H5P_DEFAULT );
-            
-            // Write
-            writeField( dset_id, itime );
-            
-            // Attributes for openPMD
-            openPMD_->writeFieldAttributes( dset_id, subgrid_start_, subgrid_step_ );
-            openPMD_->writeRecordAttributes( dset_id, field_type[ifield] );
-            openPMD_->writeFieldRecordAttributes( dset_id );
-            openPMD_->writeComponentAttributes( dset_id, field_type[ifield] );
-            
-            // Close dataset
-            H5Dclose( dset_id );
+            // Wait for the previous field to be written, then write this one
+            joinWriter();
+            swapBuffers();
+            field_writer = std::thread( &DiagnosticFields::writeDataset, this, ifield, itime );
         }
     }
     
     #pragma omp master
     {
+        joinWriter();
+        
         // write x_moved
         double x_moved = simWindow ? simWindow->getXmoved() : 0.;
         H5::attr( iteration_group_id, "x_moved", x_moved );
@@ -381,6 +407,101 @@ void DiagnosticFields::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     }
 }
 
+void DiagnosticFields::swapBuffers()
+{
+    data.swap( data_write );
+    data.resize( data_write.size() );
+}
+
+void DiagnosticFields::writeDataset( unsigned int ifield, int itime )
+{
+    // Create field dataset in HDF5
+    hid_t dset_id  = H5Dcreate( iteration_group_id, fields_names[ifield].c_str(), datatype_, filespace, H5P_DEFAULT, dcreate, H5P_DEFAULT );
+    
+    // Write
+    writeField( dset_id, itime );
+    
+    // Attributes for openPMD
+    openPMD_->writeFieldAttributes( dset_id, subgrid_start_, subgrid_step_ );
+    openPMD_->writeRecordAttributes( dset_id, field_type[ifield] );
+    openPMD_->writeFieldRecordAttributes( dset_id );
+    openPMD_->writeComponentAttributes( dset_id, field_type[ifield] );
+    if( error_bound_ > 0. ) {
+        openPMD_->writeErrorBoundAttributes( dset_id, field_type[ifield], error_bound_ );
+    }
+    
+    // Close dataset
+    H5Dclose( dset_id );
+}
+
+void DiagnosticFields::joinWriter()
+{
+    if( field_writer.joinable() ) {
+        field_writer.join();
+    }
+}
+
+void DiagnosticFields::setDatasetLayout( unsigned int ndim, hsize_t *dims )
+{
+    vector<hsize_t> chunk_size( dims, dims+ndim );
+    bool chunked = false;
+    
+    if( chunks_.size() > 0 ) {
+        // Chunks requested by the user
+        if( chunks_.size() != ndim ) {
+            ERROR( "Diagnostic Fields #"<<diag_n<<" `chunks` should have "<<ndim<<" elements" );
+        }
+        hsize_t chunk_bytes = sizeof( double );
+        for( unsigned int i=0; i<ndim; i++ ) {
+            chunk_size[i] = min( ( hsize_t ) max( chunks_[i], 1u ), dims[i] );
+            chunk_bytes *= chunk_size[i];
+        }
+        if( chunk_bytes > 4294967295 ) {
+            ERROR( "Diagnostic Fields #"<<diag_n<<" `chunks` too large (4 GB maximum per chunk)" );
+        }
+        chunked = true;
+    } else {
+        // Define the chunk size (necessary above 2^28 points)
+        const hsize_t max_size = 4294967295/2/sizeof( double );
+        hsize_t final_size = 1;
+        for( unsigned int i=0; i<ndim; i++ ) {
+            final_size *= dims[i];
+        }
+        if( final_size > max_size ) {
+            hsize_t n_chunks = 1 + ( final_size-1 ) / max_size;
+            chunk_size[0] = dims[0] / n_chunks;
+            if( n_chunks * chunk_size[0] < dims[0] ) {
+                chunk_size[0]++;
+            }
+            chunked = true;
+        }
+    }
+    
+    // Compression requires a chunked dataset
+    if( chunked || deflate_ > 0 ) {
+        H5Pset_layout( dcreate, H5D_CHUNKED );
+        H5Pset_chunk( dcreate, ndim, &chunk_size[0] );
+    }
+    if( deflate_ > 0 ) {
+        if( shuffle_ ) {
+            H5Pset_shuffle( dcreate );
+        }
+        H5Pset_deflate( dcreate, deflate_ );
+    }
+}
+
+void DiagnosticFields::reduceData( double *buffer, unsigned int n )
+{
+    // Quantize to multiples of twice the error bound, so that the error is within the bound
+    // and the data compresses much better
+    if( error_bound_ > 0. ) {
+        double step = 2.*error_bound_, inv_step = 1./step;
+        for( unsigned int i=0; i<n; i++ ) {
+            buffer[i] = step * round( buffer[i] * inv_step );
+        }
+    }
+}
+
 bool DiagnosticFields::needsRhoJs( int itime )
 {
     return hasRhoJs && timeSelection->theTimeIsNow( itime );
@@ -405,7 +526,7 @@ uint64_t DiagnosticFields::getDiskFootPrint( int istart, int istop, Patch *patch
     footprint += ndumps * nfields * 1200;
     
     // Add size of each field
-    footprint += ndumps * nfields * ( uint64_t )( total_dataset_size * 8 );
+    footprint += ndumps * nfields * ( uint64_t )( total_dataset_size * H5Tget_size( datatype_ ) );
     
     return footprint;
 }
@@ -1,6 +1,8 @@
 #ifndef DIAGNOSTICFIELDS_H
 #define DIAGNOSTICFIELDS_H
 
+#include <thread>
+
 #include "Diagnostic.h"
 
 class DiagnosticFields  : public Diagnostic
@@ -23,6 +25,7 @@ public :
     
     virtual void run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime, SimWindow *simWindow, Timers &timers ) override;
     
+    //! Write the "data_write" buffer to the given dataset
     virtual void writeField( hid_t, int ) = 0;
     
     virtual bool needsRhoJs( int itime ) override;
@@ -75,6 +78,41 @@ protected :
     std::vector<unsigned int> patch_size;
     //! Buffer for the output of a field
     std::vector<double> data;
+    //! Buffer of the previous field, being written while "data" is filled with the next one
+    std::vector<double> data_write;
+    
+    //! Thread writing the previous field while the next one is gathered
+    std::thread field_writer;
+    
+    //! Hand the gathered "data" buffer over to the writer (swaps it with "data_write")
+    virtual void swapBuffers();
+    
+    //! Create, write and close the dataset of one field (runs in the field_writer thread)
+    void writeDataset( unsigned int ifield, int itime );
+    
+    //! Wait for the field_writer thread to finish
+    void joinWriter();
+    
+    //! Set the chunking and compression of the final datasets, given their dimensions
+    void setDatasetLayout( unsigned int ndim, hsize_t *dims );
+    
+    //! Chunk size requested in each dimension of the datasets (empty for automatic)
+    std::vector<unsigned int> chunks_;
+    
+    //! Deflate level of the datasets (0 for no compression)
+    int deflate_;
+    
+    //! Whether the shuffle filter is applied before deflate
+    bool shuffle_;
+    
+    //! HDF5 type of the datasets in the file (double or float)
+    hid_t datatype_;
+    
+    //! Absolute error bound of the lossy quantization (0 for none)
+    double error_bound_;
+    
+    //! Apply the lossy reduction to the portion of the buffer filled by one patch
+    void reduceData( double *buffer, unsigned int n );
     
     //! 1st patch index of vecPatches
     unsigned int refHindex;
@@ -33,6 +33,8 @@ DiagnosticFields1D::DiagnosticFields1D( Params &params, SmileiMPI *smpi, VectorP
     total_dataset_size = nsteps;
     filespace = H5Screate_simple( 1, &file_size, NULL );
     memspace  = H5Screate_simple( 1, &file_size, NULL );
+    
+    setDatasetLayout( 1, &file_size );
 }
 
 DiagnosticFields1D::~DiagnosticFields1D()
@@ -111,6 +113,7 @@ void DiagnosticFields1D::getField( Patch *patch, unsigned int ifield )
         ix--;
     }
     iout -= MPI_start_in_file;
+    unsigned int ibuffer = iout;
     unsigned int ix_max = ix + nsteps * subgrid_step_[0];
     
     // Copy this patch field into buffer
@@ -120,6 +123,8 @@ void DiagnosticFields1D::getField( Patch *patch, unsigned int ifield )
         iout++;
     }
     
+    reduceData( data.data() + ibuffer, iout-ibuffer );
+    
     if( time_average>1 ) {
         field->put_to( 0.0 );
     }
@@ -130,7 +135,7 @@ void DiagnosticFields1D::getField( Patch *patch, unsigned int ifield )
 void DiagnosticFields1D::writeField( hid_t dset_id, int itime )
 {
 
-    H5Dwrite( dset_id, H5T_NATIVE_DOUBLE, memspace, filespace, write_plist, &( data[0] ) );
+    H5Dwrite( dset_id, H5T_NATIVE_DOUBLE, memspace, filespace, write_plist, &( data_write[0] ) );
     
 }
 
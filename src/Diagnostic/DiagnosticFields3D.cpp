@@ -167,21 +167,7 @@ DiagnosticFields3D::DiagnosticFields3D( Params &params, SmileiMPI *smpi, VectorP
         H5Pset_chunk( dcreate_firstwrite, 1, &chunk_size );
     }
     // For the second write
-    hsize_t final_size = final_array_size[0]
-                         *final_array_size[1]
-                         *final_array_size[2];
-    if( final_size > max_size ) {
-        hsize_t n_chunks = 1 + ( final_size-1 ) / max_size;
-        hsize_t chunk_size[3];
-        chunk_size[0] = final_array_size[0] / n_chunks;
-        chunk_size[1] = final_array_size[1];
-        chunk_size[2] = final_array_size[2];
-        if( n_chunks * chunk_size[0] < final_array_size[0] ) {
-            chunk_size[0]++;
-        }
-        H5Pset_layout( dcreate, H5D_CHUNKED );
-        H5Pset_chunk( dcreate, 3, chunk_size );
-    }
+    setDatasetLayout( 3, final_array_size );
     
     tmp_dset_id=0;
 }
@@ -212,7 +198,7 @@ void DiagnosticFields3D::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatc
     // Create/Open temporary dataset
     status = H5Lexists( fileId_, "tmp", H5P_DEFAULT );
     if( status == 0 ) {
-        tmp_dset_id  = H5Dcreate( fileId_, "tmp", H5T_NATIVE_DOUBLE, filespace_firstwrite, H5P_DEFAULT, dcreate_firstwrite, H5P_DEFAULT );
+        tmp_dset_id  = H5Dcreate( fileId_, "tmp", datatype_, filespace_firstwrite, H5P_DEFAULT, dcreate_firstwrite, H5P_DEFAULT );
     } else {
         hid_t pid = H5Pcreate( H5P_DATASET_ACCESS );
         tmp_dset_id = H5Dopen( fileId_, "tmp", pid );
@@ -256,6 +242,7 @@ void DiagnosticFields3D::getField( Patch *patch, unsigned int ifield )
     unsigned int iy_max = istart_in_patch[1] + subgrid_step_[1]*nsteps[1];
     unsigned int iz_max = istart_in_patch[2] + subgrid_step_[2]*nsteps[2];
     unsigned int iout = one_patch_buffer_size * ( patch->Hindex()-refHindex );
+    unsigned int ibuffer = iout;
     for( unsigned int ix = istart_in_patch[0]; ix < ix_max; ix += subgrid_step_[0] ) {
         for( unsigned int iy = istart_in_patch[1]; iy < iy_max; iy += subgrid_step_[1] ) {
             for( unsigned int iz = istart_in_patch[2]; iz < iz_max; iz += subgrid_step_[2] ) {
@@ -265,6 +252,8 @@ void DiagnosticFields3D::getField( Patch *patch, unsigned int ifield )
         }
     }
     
+    reduceData( data.data() + ibuffer, iout-ibuffer );
+    
     if( time_average>1 ) {
         field->put_to( 0.0 );
     }
@@ -276,7 +265,7 @@ void DiagnosticFields3D::writeField( hid_t dset_id, int itime )
 {
 
     // Write the buffer in a temporary location
-    H5Dwrite( tmp_dset_id, H5T_NATIVE_DOUBLE, memspace_firstwrite, filespace_firstwrite, write_plist, &( data[0] ) );
+    H5Dwrite( tmp_dset_id, H5T_NATIVE_DOUBLE, memspace_firstwrite, filespace_firstwrite, write_plist, &( data_write[0] ) );
     
     // Read the file with the previously defined partition
     H5Dread( tmp_dset_id, H5T_NATIVE_DOUBLE, memspace_reread, filespace_reread, write_plist, &( data_reread[0] ) );
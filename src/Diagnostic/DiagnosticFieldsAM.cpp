@@ -115,6 +115,8 @@ DiagnosticFieldsAM::DiagnosticFieldsAM( Params &params, SmileiMPI *smpi, VectorP
     memspace = H5Screate_simple( 2, iblock2, NULL );
     idata_rewrite.resize( block2[0]*block2[1] );
     
+    setDatasetLayout( 2, ifinal_array_size );
+    
     tmp_dset_id=0;
 }
 
@@ -123,6 +125,13 @@ DiagnosticFieldsAM::~DiagnosticFieldsAM()
 }
 
 
+void DiagnosticFieldsAM::swapBuffers()
+{
+    idata.swap( idata_write );
+    idata.resize( idata_write.size() );
+}
+
+
 void DiagnosticFieldsAM::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatches )
 {
     // Calculate the total size of the array in this proc
@@ -148,7 +157,7 @@ void DiagnosticFieldsAM::setFileSplitting( SmileiMPI *smpi, VectorPatch &vecPatc
     status = H5Lexists( fileId_, "tmp", H5P_DEFAULT );
     if( status == 0 ) {
         hid_t pid = H5Pcreate( H5P_DATASET_CREATE );
-        tmp_dset_id  = H5Dcreate( fileId_, "tmp", H5T_NATIVE_DOUBLE, filespace_firstwrite, H5P_DEFAULT, pid, H5P_DEFAULT );
+        tmp_dset_id  = H5Dcreate( fileId_, "tmp", datatype_, filespace_firstwrite, H5P_DEFAULT, pid, H5P_DEFAULT );
         H5Pclose( pid );
     } else {
         hid_t pid = H5Pcreate( H5P_DATASET_ACCESS );
@@ -175,6 +184,7 @@ void DiagnosticFieldsAM::getField( Patch *patch, unsigned int ifield )
     unsigned int iy;
     unsigned int iy_max = patch_offset_in_grid[1] + patch_size[1];
     unsigned int iout = one_patch_buffer_size * ( patch->Hindex()-refHindex );
+    unsigned int ibuffer = iout;
     while( ix < ix_max ) {
         iy = patch_offset_in_grid[1];
         while( iy < iy_max ) {
@@ -192,6 +202,9 @@ void DiagnosticFieldsAM::getField( Patch *patch, unsigned int ifield )
 //        data_pt += patch_size[1];
 //    }
 
+    // Apply the lossy reduction to the real and imaginary parts
+    reduceData( reinterpret_cast<double *>( idata.data() + ibuffer ), 2*( iout-ibuffer ) );
+    
     if( time_average>1 ) {
         field->put_to( 0.0 );
     }
@@ -203,7 +216,7 @@ void DiagnosticFieldsAM::writeField( hid_t dset_id, int itime )
 {
 
     // Write the buffer in a temporary location
-    H5Dwrite( tmp_dset_id, H5T_NATIVE_DOUBLE, memspace_firstwrite, filespace_firstwrite, write_plist, &( idata[0] ) );
+    H5Dwrite( tmp_dset_id, H5T_NATIVE_DOUBLE, memspace_firstwrite, filespace_firstwrite, write_plist, &( idata_write[0] ) );
     
     // Read the file with the previously defined partition
     H5Dread( tmp_dset_id, H5T_NATIVE_DOUBLE, memspace_reread, filespace_reread, write_plist, &( idata_reread[0] ) );
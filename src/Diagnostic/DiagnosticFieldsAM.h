@@ -21,12 +21,16 @@ public:
     
     void writeField( hid_t, int ) override;
     
+protected:
+
+    void swapBuffers() override;
+    
 private:
 
     unsigned int rewrite_npatch, rewrite_xmin, rewrite_ymin, rewrite_npatchx, rewrite_npatchy;
     std::vector<unsigned int> rewrite_patches_x, rewrite_patches_y;
     
-    std::vector<std::complex<double>> idata_reread, idata_rewrite, idata;
+    std::vector<std::complex<double>> idata_reread, idata_rewrite, idata, idata_write;
     
 };
 
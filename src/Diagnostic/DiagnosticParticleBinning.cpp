@@ -1,5 +1,6 @@
 #include "PyTools.h"
 #include <iomanip>
+#include <omp.h>
 
 #include "DiagnosticParticleBinning.h"
 #include "HistogramFactory.h"
@@ -94,6 +95,18 @@ DiagnosticParticleBinning::DiagnosticParticleBinning( Params &params, SmileiMPI
     }
     output_size = ( unsigned int ) total_size;
     
+    // With several threads, each thread fills its own histogram, unless it takes too much memory
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    if( nthreads > 1 && output_size <= 1048576 ) { // 2^20
+        data_thread.resize( nthreads );
+    }
+    
+    reduction_request = MPI_REQUEST_NULL;
+    reduction_timestep = 0;
+    
     // Output info on diagnostics
     if( smpi->isMaster() ) {
         ostringstream mystream( "" );
@@ -127,6 +140,7 @@ DiagnosticParticleBinning::DiagnosticParticleBinning( Params &params, SmileiMPI
 
 DiagnosticParticleBinning::~DiagnosticParticleBinning()
 {
+    finishReduction( true );
     delete timeSelection;
     delete flush_timeSelection;
 } // END DiagnosticParticleBinning::~DiagnosticParticleBinning
@@ -183,6 +197,8 @@ void DiagnosticParticleBinning::openFile( Params &params, SmileiMPI *smpi, bool
 
 void DiagnosticParticleBinning::closeFile()
 {
+    finishReduction( true );
+    
     if( fileId_!=0 ) {
         H5Fclose( fileId_ );
         fileId_ = 0;
@@ -193,6 +209,9 @@ void DiagnosticParticleBinning::closeFile()
 
 bool DiagnosticParticleBinning::prepare( int timestep )
 {
+    // Write the result of the previous MPI reduction if it has arrived
+    finishReduction( false );
+    
     // Get the previous timestep of the time selection
     int previousTime = timeSelection->previousTime( timestep );
     
@@ -209,6 +228,11 @@ bool DiagnosticParticleBinning::prepare( int timestep )
         fill( data_sum.begin(), data_sum.end(), 0. );
     }
     
+    // Allocate the private arrays of each thread (they are kept to zero by mergeThreads)
+    for( unsigned int ithread=0; ithread<data_thread.size(); ithread++ ) {
+        data_thread[ithread].resize( output_size, 0. );
+    }
+    
     return true;
     
 } // END prepare
@@ -222,6 +246,13 @@ void DiagnosticParticleBinning::run( Patch *patch, int timestep, SimWindow *simW
     vector<double> double_buffer;
     unsigned int npart, ndim = spatial_min.size();
     
+    int ithread;
+#ifdef _OPENMP
+    ithread = omp_get_thread_num();
+#else
+    ithread = 0;
+#endif
+    
     // Update spatial_min and spatial_max if needed
     for( unsigned int i=0; i<histogram->axes.size(); i++ ) {
         if( histogram->axes[i]->type == "moving_x" ) {
@@ -249,68 +280,110 @@ void DiagnosticParticleBinning::run( Patch *patch, int timestep, SimWindow *simW
         
         histogram->digitize( s, double_buffer, int_buffer, simWindow );
         histogram->valuate( s, double_buffer, int_buffer );
-        histogram->distribute( double_buffer, int_buffer, data_sum );
+        if( data_thread.size() > 0 ) {
+            histogram->distribute( double_buffer, int_buffer, data_thread[ithread], false );
+        } else {
+            histogram->distribute( double_buffer, int_buffer, data_sum );
+        }
         
     }
     
 } // END run
 
 
-// Now the data_sum has been filled
-// if needed now, store result to hdf file
-void DiagnosticParticleBinning::write( int timestep, SmileiMPI *smpi )
+// Sum the private arrays of all threads into data_sum
+// Each thread takes care of a slice of the bins, so that no synchronization is needed
+void DiagnosticParticleBinning::mergeThreads()
 {
-    if( !smpi->isMaster() ) {
+    unsigned int nthreads = data_thread.size();
+    if( nthreads == 0 ) {
         return;
     }
     
-    if( timestep - timeSelection->previousTime() != time_average-1 ) {
-        return;
+    #pragma omp for schedule(static)
+    for( unsigned int i=0; i<output_size; i++ ) {
+        double sum = 0.;
+        for( unsigned int ithread=0; ithread<nthreads; ithread++ ) {
+            sum += data_thread[ithread][i];
+            data_thread[ithread][i] = 0.;
+        }
+        data_sum[i] += sum;
     }
     
-    double coeff;
-    // if time_average, then we need to divide by the number of timesteps
-    if( time_average > 1 ) {
-        coeff = 1./( ( double )time_average );
-        for( unsigned int i=0; i<output_size; i++ ) {
-            data_sum[i] *= coeff;
-        }
+} // END mergeThreads
+
+
+// The MPI reduction of data_sum has been started by SmileiMPI::computeGlobalDiags
+// It is written out when it completes, possibly at a later timestep
+void DiagnosticParticleBinning::write( int timestep, SmileiMPI *smpi )
+{
+    finishReduction( false );
+} // END write
+
+
+// Once the reduction is complete, the master stores the result to hdf file
+void DiagnosticParticleBinning::finishReduction( bool wait )
+{
+    if( reduction_request == MPI_REQUEST_NULL ) {
+        return;
     }
     
-    // make name of the array
-    ostringstream mystream( "" );
-    mystream.str( "" );
-    mystream << "timestep" << setw( 8 ) << setfill( '0' ) << timestep;
-    
-    // write the array if it does not exist already
-    if( ! H5Lexists( fileId_, mystream.str().c_str(), H5P_DEFAULT ) ) {
-        // Prepare array dimensions
-        unsigned int naxes = histogram->axes.size();
-        hsize_t dims[naxes];
-        for( unsigned int iaxis=0; iaxis<naxes; iaxis++ ) {
-            dims[iaxis] = histogram->axes[iaxis]->nbins;
-        }
-        // Create file space
-        hid_t sid = H5Screate_simple( naxes, &dims[0], NULL );
-        hid_t pid = H5Pcreate( H5P_DATASET_CREATE );
-        // create dataset
-        hid_t did = H5Dcreate( fileId_, mystream.str().c_str(), H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, pid, H5P_DEFAULT );
-        // write vector in dataset
-        H5Dwrite( did, H5T_NATIVE_DOUBLE, sid, sid, H5P_DEFAULT, &data_sum[0] );
-        // close all
-        H5Dclose( did );
-        H5Pclose( pid );
-        H5Sclose( sid );
+    int done = 1;
+    if( wait ) {
+        MPI_Wait( &reduction_request, MPI_STATUS_IGNORE );
+    } else {
+        MPI_Test( &reduction_request, &done, MPI_STATUS_IGNORE );
+    }
+    if( !done ) {
+        return;
     }
     
-    if( flush_timeSelection->theTimeIsNow( timestep ) ) {
-        H5Fflush( fileId_, H5F_SCOPE_GLOBAL );
+    // Only the master has opened the file
+    if( fileId_ > 0 ) {
+    
+        double coeff;
+        // if time_average, then we need to divide by the number of timesteps
+        if( time_average > 1 ) {
+            coeff = 1./( ( double )time_average );
+            for( unsigned int i=0; i<output_size; i++ ) {
+                data_reduced[i] *= coeff;
+            }
+        }
+        
+        // make name of the array
+        ostringstream mystream( "" );
+        mystream.str( "" );
+        mystream << "timestep" << setw( 8 ) << setfill( '0' ) << reduction_timestep;
+        
+        // write the array if it does not exist already
+        if( ! H5Lexists( fileId_, mystream.str().c_str(), H5P_DEFAULT ) ) {
+            // Prepare array dimensions
+            unsigned int naxes = histogram->axes.size();
+            hsize_t dims[naxes];
+            for( unsigned int iaxis=0; iaxis<naxes; iaxis++ ) {
+                dims[iaxis] = histogram->axes[iaxis]->nbins;
+            }
+            // Create file space
+            hid_t sid = H5Screate_simple( naxes, &dims[0], NULL );
+            hid_t pid = H5Pcreate( H5P_DATASET_CREATE );
+            // create dataset
+            hid_t did = H5Dcreate( fileId_, mystream.str().c_str(), H5T_NATIVE_DOUBLE, sid, H5P_DEFAULT, pid, H5P_DEFAULT );
+            // write vector in dataset
+            H5Dwrite( did, H5T_NATIVE_DOUBLE, sid, sid, H5P_DEFAULT, &data_reduced[0] );
+            // close all
+            H5Dclose( did );
+            H5Pclose( pid );
+            H5Sclose( sid );
+        }
+        
+        if( flush_timeSelection->theTimeIsNow( reduction_timestep ) ) {
+            H5Fflush( fileId_, H5F_SCOPE_GLOBAL );
+        }
     }
     
     // Clear the array
-    clear();
-    data_sum.resize( 0 );
-} // END write
+    vector<double>().swap( data_reduced );
+} // END finishReduction
 
 
 //! Clear the array
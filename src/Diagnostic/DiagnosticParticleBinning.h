@@ -1,6 +1,8 @@
 #ifndef DIAGNOSTICPARTICLEBINNING_H
 #define DIAGNOSTICPARTICLEBINNING_H
 
+#include <mpi.h>
+
 #include "Diagnostic.h"
 
 #include "Histogram.h"
@@ -26,15 +28,20 @@ public :
     
     void run( Patch *patch, int timestep, SimWindow *simWindow ) override;
     
+    void mergeThreads() override;
+    
     void write( int timestep, SmileiMPI *smpi ) override;
     
     //! Clear the array
     void clear();
     
+    //! Completes the pending MPI reduction (if wait is false, only if it already finished), and writes its result
+    void finishReduction( bool wait );
+    
     //! Get memory footprint of current diagnostic
     int getMemFootPrint() override
     {
-        int size = output_size*sizeof( double );
+        int size = ( 2 + data_thread.size() )*output_size*sizeof( double );
         // + data_array + index_array +  axis_array
         // + nparts_max * (sizeof(double)+sizeof(int)+sizeof(double))
         return size;
@@ -54,6 +61,16 @@ private :
     //! vector for saving the output array for time-averaging
     std::vector<double> data_sum;
     
+    //! private output arrays of each thread (empty if the threads share data_sum)
+    std::vector<std::vector<double> > data_thread;
+    
+    //! output array being reduced over MPI while the simulation goes on
+    std::vector<double> data_reduced;
+    
+    //! request of the pending MPI reduction, and its timestep
+    MPI_Request reduction_request;
+    int reduction_timestep;
+    
     //! Histogram object
     Histogram *histogram;
     
@@ -7,6 +7,8 @@
 #include "DiagnosticProbes.h"
 
 #include "VectorPatch.h"
+#include "ElectroMagn.h"
+#include "Interpolator.h"
 
 
 using namespace std;
@@ -89,6 +91,7 @@ DiagnosticProbes::DiagnosticProbes( Params &params, SmileiMPI *smpi, VectorPatch
     hasRhoJs = false;
     last_iteration_points_calculated = 0;
     positions_written = false;
+    stencils_outdated = true;
     
     // Extract "every" (time selection)
     ostringstream name( "" );
@@ -284,6 +287,15 @@ DiagnosticProbes::DiagnosticProbes( Params &params, SmileiMPI *smpi, VectorPatch
     fieldname = fs;
     nFields = fs.size();
     
+    // Interpolate with cached stencils when the interpolator provides them
+    stencil_size = vecPatches( 0 )->probesInterp->stencilSize();
+    interpolated_fields.resize( 0 );
+    for( unsigned int i=0; i<13; i++ ) {
+        if( locations[i] < fs.size() ) {
+            interpolated_fields.push_back( i );
+        }
+    }
+    
     // Pre-calculate patch size
     patch_size.resize( nDim_particle );
     for( unsigned int k=0; k<nDim_particle; k++ ) {
@@ -592,6 +604,7 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int timest
         if( !positions_written || last_iteration_points_calculated <= vecPatches.lastIterationPatchesMoved ) {
             createPoints( smpi, vecPatches, false, x_moved );
             last_iteration_points_calculated = timestep;
+            stencils_outdated = true;
             
             // Store the positions of all particles, unless done already
             if( !positions_written ) {
@@ -669,6 +682,31 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int timest
     // Loop patches to fill the array
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<nPatches ; ipatch++ ) {
+    
+        // Interpolate only the requested fields, with the cached stencils
+        if( stencil_size > 0 ) {
+            if( stencils_outdated ) {
+                computeStencils( vecPatches( ipatch ) );
+            }
+            ElectroMagn *EMfields = vecPatches( ipatch )->EMfields;
+            ProbeParticles *probe = vecPatches( ipatch )->probes[probe_n];
+            for( unsigned int i=0; i<interpolated_fields.size(); i++ ) {
+                unsigned int ifield = interpolated_fields[i];
+                // Envelope fields are interpolated on the primal grid
+                bool envelope = ifield >= 10;
+                if( envelope && EMfields->envelope == NULL ) {
+                    continue;
+                }
+                double *FieldLoc = &( ( *probesArray )( fieldlocation[ifield], offset_in_MPI[ipatch] ) );
+                interpolateField( probedField( EMfields, ifield ), probe, envelope, FieldLoc );
+            }
+            for( unsigned int ifield=0; ifield<fieldindex.size(); ifield++ ) {
+                double *FieldLoc = &( ( *probesArray )( fieldlocation[13+ifield], offset_in_MPI[ipatch] ) );
+                interpolateField( EMfields->allFields[fieldindex[ifield]], probe, false, FieldLoc );
+            }
+            continue;
+        }
+        
         // Loop probe ("fake") particles of current patch
         unsigned int iPart_MPI = offset_in_MPI[ipatch];
         unsigned int npart = vecPatches( ipatch )->probes[probe_n]->particles.size();
@@ -782,6 +820,7 @@ void DiagnosticProbes::run( SmileiMPI *smpi, VectorPatch &vecPatches, int timest
         H5Sclose( memspace );
         
         delete probesArray;
+        stencils_outdated = false;
         
         if( flush_timeSelection->theTimeIsNow( timestep ) ) {
             H5Fflush( fileId_, H5F_SCOPE_GLOBAL );
@@ -795,6 +834,119 @@ bool DiagnosticProbes::needsRhoJs( int timestep )
     return hasRhoJs && timeSelection->theTimeIsNow( timestep );
 }
 
+Field *DiagnosticProbes::probedField( ElectroMagn *EMfields, unsigned int ifield )
+{
+    switch( ifield ) {
+        case 0:
+            return EMfields->Ex_;
+        case 1:
+            return EMfields->Ey_;
+        case 2:
+            return EMfields->Ez_;
+        case 3:
+            return EMfields->Bx_m;
+        case 4:
+            return EMfields->By_m;
+        case 5:
+            return EMfields->Bz_m;
+        case 6:
+            return EMfields->Jx_;
+        case 7:
+            return EMfields->Jy_;
+        case 8:
+            return EMfields->Jz_;
+        case 9:
+            return EMfields->rho_;
+        case 10:
+            return EMfields->Env_A_abs_;
+        case 11:
+            return EMfields->Env_Chi_;
+        default:
+            return EMfields->Env_E_abs_;
+    }
+}
+
+void DiagnosticProbes::computeStencils( Patch *patch )
+{
+    ProbeParticles *probe = patch->probes[probe_n];
+    unsigned int npart = probe->particles.size();
+    vector<double> weights( stencil_size );
+    
+    for( unsigned int dual=0; dual<2; dual++ ) {
+        probe->stencil_first  [dual].resize( nDim_field*npart );
+        probe->stencil_weights[dual].resize( nDim_field*stencil_size*npart );
+        for( unsigned int idim=0; idim<nDim_field; idim++ ) {
+            int *first = &( probe->stencil_first[dual][idim*npart] );
+            double *w = &( probe->stencil_weights[dual][idim*stencil_size*npart] );
+            for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+                patch->probesInterp->stencil( idim, probe->particles.position( idim, ipart ), dual, first[ipart], &weights[0] );
+                for( unsigned int k=0; k<stencil_size; k++ ) {
+                    w[k*npart+ipart] = weights[k];
+                }
+            }
+        }
+    }
+}
+
+void DiagnosticProbes::interpolateField( Field *field, ProbeParticles *probe, bool primal, double *FieldLoc )
+{
+    unsigned int npart = probe->particles.size();
+    if( npart == 0 ) {
+        return;
+    }
+    unsigned int S = stencil_size;
+    double *F = field->data();
+    
+    // Stencils on the grid (primal or dual) of this field, in each dimension
+    int *first[3];
+    double *w[3];
+    for( unsigned int idim=0; idim<nDim_field; idim++ ) {
+        unsigned int dual = ( !primal && field->isDual( idim ) ) ? 1 : 0;
+        first[idim] = &( probe->stencil_first[dual][idim*npart] );
+        w[idim] = &( probe->stencil_weights[dual][idim*S*npart] );
+    }
+    
+    if( nDim_field == 1 ) {
+        #pragma omp simd
+        for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+            double *f = &F[first[0][ipart]];
+            double res = 0.;
+            for( unsigned int i=0; i<S; i++ ) {
+                res += w[0][i*npart+ipart] * f[i];
+            }
+            FieldLoc[ipart] = res;
+        }
+    } else if( nDim_field == 2 ) {
+        int ny = field->dims_[1];
+        #pragma omp simd
+        for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+            double *f = &F[first[0][ipart]*ny + first[1][ipart]];
+            double res = 0.;
+            for( unsigned int i=0; i<S; i++ ) {
+                for( unsigned int j=0; j<S; j++ ) {
+                    res += w[0][i*npart+ipart] * w[1][j*npart+ipart] * f[i*ny+j];
+                }
+            }
+            FieldLoc[ipart] = res;
+        }
+    } else {
+        int ny = field->dims_[1], nz = field->dims_[2];
+        #pragma omp simd
+        for( unsigned int ipart=0; ipart<npart; ipart++ ) {
+            double *f = &F[( first[0][ipart]*ny + first[1][ipart] )*nz + first[2][ipart]];
+            double res = 0.;
+            for( unsigned int i=0; i<S; i++ ) {
+                for( unsigned int j=0; j<S; j++ ) {
+                    for( unsigned int k=0; k<S; k++ ) {
+                        res += w[0][i*npart+ipart] * w[1][j*npart+ipart] * w[2][k*npart+ipart] * f[( i*ny+j )*nz+k];
+                    }
+                }
+            }
+            FieldLoc[ipart] = res;
+        }
+    }
+}
+
 // SUPPOSED TO BE EXECUTED ONLY BY MASTER MPI
 uint64_t DiagnosticProbes::getDiskFootPrint( int istart, int istop, Patch *patch )
 {
@@ -6,6 +6,9 @@
 #include "Field2D.h"
 
 
+class ProbeParticles;
+class ElectroMagn;
+
 class DiagnosticProbes : public Diagnostic
 {
     friend class SmileiMPI;
@@ -40,6 +43,8 @@ public :
                    ( nDim_particle+3+1 )*sizeof( double ) + sizeof( short )
                    // eval probesArray (even if temporary)
                    + 10*sizeof( double )
+                   // cached interpolation stencils
+                   + 2*nDim_field*( sizeof( int ) + stencil_size*sizeof( double ) )
                );
     }
     
@@ -121,6 +126,25 @@ private :
     
     //! patch size
     std::vector<double> patch_size;
+    
+    //! Number of nodes of the cached interpolation stencils along each dimension
+    //! (0 if the interpolator does not provide stencils: each point is then interpolated like a particle)
+    unsigned int stencil_size;
+    
+    //! Whether the stencils must be re-computed because the points have changed
+    bool stencils_outdated;
+    
+    //! Indices, in fieldlocation, of the requested fields among the usual ones (Ex, Ey, ... Env_E_abs)
+    std::vector<unsigned int> interpolated_fields;
+    
+    //! Usual field corresponding to an index in fieldlocation
+    Field *probedField( ElectroMagn *EMfields, unsigned int ifield );
+    
+    //! Compute the interpolation stencils of all the points of a patch
+    void computeStencils( Patch *patch );
+    
+    //! Interpolate a field at all the points of a patch, using the cached stencils
+    void interpolateField( Field *field, ProbeParticles *probe, bool primal, double *FieldLoc );
 };
 
 
@@ -137,6 +161,12 @@ public :
     
     Particles particles;
     int offset_in_file;
+    
+    //! Cached interpolation stencils on the primal [0] and dual [1] grids:
+    //! first node of each point along each dimension, indexed [idim*npoints+ipoint]
+    std::vector<int> stencil_first[2];
+    //! and their weights, indexed [(idim*stencil_size+k)*npoints+ipoint]
+    std::vector<double> stencil_weights[2];
 };
 
 
@@ -11,7 +11,8 @@ using namespace std;
 
 
 DiagnosticScalar::DiagnosticScalar( Params &params, SmileiMPI *smpi, Patch *patch = NULL ):
-    latest_timestep( -1 )
+    latest_timestep( -1 ),
+    reduction_timestep( -1 )
 {
     // patch  == NULL else error
     filename = "scalars.txt";
@@ -47,6 +48,7 @@ DiagnosticScalar::DiagnosticScalar( Params &params, SmileiMPI *smpi, Patch *patc
 
 DiagnosticScalar::~DiagnosticScalar()
 {
+    finishReduction( true );
     for( unsigned int i=0; i<allScalars.size(); i++ ) {
         delete allScalars[i];
     }
@@ -80,6 +82,8 @@ void DiagnosticScalar::openFile( Params &params, SmileiMPI *smpi, bool newfile )
 
 void DiagnosticScalar::closeFile()
 {
+    finishReduction( true );
+    
     if( fout.is_open() ) {
         fout.close();
     }
@@ -321,6 +325,9 @@ void DiagnosticScalar::init( Params &params, SmileiMPI *smpi, VectorPatch &vecPa
 
 bool DiagnosticScalar::prepare( int timestep )
 {
+    // Write the result of the previous MPI reductions if they have arrived
+    finishReduction( false );
+    
     // At the right timestep, reset the scalars
     if( timeSelection->theTimeIsNow( timestep ) )
         for( unsigned int iscalar=0 ; iscalar<allScalars.size() ; iscalar++ ) {
@@ -348,59 +355,141 @@ void DiagnosticScalar::run( Patch *patch, int timestep, SimWindow *simWindow )
 
 void DiagnosticScalar::write( int itime, SmileiMPI *smpi )
 {
-    if( smpi->isMaster() ) {
+    // The reduction started by SmileiMPI::computeGlobalDiags is written once it completes
+    finishReduction( false );
+    
+    latest_timestep = itime;
+    
+} // END write
+
+
+void DiagnosticScalar::finishReduction( bool wait )
+{
+    if( reduction_requests.empty() ) {
+        return;
+    }
+    
+    int done = 1;
+    if( wait ) {
+        MPI_Waitall( reduction_requests.size(), &reduction_requests[0], MPI_STATUSES_IGNORE );
+    } else {
+        MPI_Testall( reduction_requests.size(), &reduction_requests[0], &done, MPI_STATUSES_IGNORE );
+    }
+    if( !done ) {
+        return;
+    }
+    reduction_requests.clear();
+    
+    // Only the master has opened the file
+    if( fout.is_open() ) {
+        // The scalars point to the current values: temporarily replace them by the reduced ones
+        values_SUM.swap( reduced_SUM );
+        values_MINLOC.swap( reduced_MINLOC );
+        values_MAXLOC.swap( reduced_MAXLOC );
+        
+        completeScalars( reduction_timestep );
+        writeScalars( reduction_timestep );
+        
+        values_SUM.swap( reduced_SUM );
+        values_MINLOC.swap( reduced_MINLOC );
+        values_MAXLOC.swap( reduced_MAXLOC );
+    }
     
-        if( timeSelection->theTimeIsNow( itime ) && itime>latest_timestep ) {
+} // END finishReduction
+
+
+// Complete the computation of the scalars after all reductions
+void DiagnosticScalar::completeScalars( int timestep )
+{
+    // Calculate average Z
+    for( unsigned int ispec=0; ispec<sDens.size(); ispec++ )
+        if( sDens[ispec] && necessary_species[ispec] ) {
+            *sZavg[ispec] = ( double )*sZavg[ispec] / ( double )*sDens[ispec];
+        }
         
-            unsigned int j, k, s = allScalars.size();
+    // total energy in the simulation
+    if( necessary_Utot ) {
+        *Utot = ( double )*Ukin + ( double )*Uelm + ( double )*Urad;
+    }
+    
+    // expected total energy
+    if( necessary_Uexp ) {
+        // total energy at time 0
+        if( timestep==0 ) {
+            Energy_time_zero = *Utot;
+        }
+        // Initial energy, plus BC and moving window gains, minus losses
+        *Uexp = Energy_time_zero + ( double )*Uelm_bnd + ( double )*Ukin_inj_mvw
+                + ( double )*Uelm_inj_mvw
+                - ( ( double )*Ukin_bnd + ( double )*Ukin_out_mvw + ( double )*Uelm_out_mvw );
+    }
+    
+    if( necessary_Ubal ) {
+        // energy balance
+        double Ubal_value = ( double )*Utot - ( double )*Uexp;
+        *Ubal = Ubal_value;
+        
+        if( necessary_Ubal_norm ) {
+            // the normalized energy balanced is normalized with respect to the current energy
+            EnergyUsedForNorm = *Utot;
+            // normalized energy balance
+            double Ubal_norm_value( 0. );
+            if( EnergyUsedForNorm>0. ) {
+                Ubal_norm_value = Ubal_value / EnergyUsedForNorm;
+            }
             
-            fout << std::scientific << setprecision( precision );
-            // At the beginning of the file, we write some headers
-            if( fout.tellp()==ifstream::pos_type( 0 ) ) { // file beginning
-                // First header: list of scalars, one by line
-                fout << "# " << 1 << " time" << endl;
-                j = 2;
-                for( k=0; k<s; k++ ) {
-                    if( allScalars[k]->allowed_ ) {
-                        fout << "# " << j << " " << allScalars[k]->name_ << endl;
-                        j++;
-                        if( ! allScalars[k]->secondname_.empty() ) {
-                            fout << "# " << j << " " << allScalars[k]->secondname_ << endl;
-                            j++;
-                        }
-                    }
-                }
-                // Second header: list of scalars, but all in one line
-                fout << "#\n#" << setw( precision+9 ) << "time";
-                for( k=0; k<s; k++ ) {
-                    if( allScalars[k]->allowed_ ) {
-                        fout << setw( allScalars[k]->width_ ) << allScalars[k]->name_;
-                        if( ! allScalars[k]->secondname_.empty() ) {
-                            fout << setw( allScalars[k]->width_ ) << allScalars[k]->secondname_;
-                        }
-                    }
+            *Ubal_norm = Ubal_norm_value;
+        }
+    }
+    
+} // END completeScalars
+
+
+void DiagnosticScalar::writeScalars( int timestep )
+{
+    unsigned int j, k, s = allScalars.size();
+    
+    fout << std::scientific << setprecision( precision );
+    // At the beginning of the file, we write some headers
+    if( fout.tellp()==ifstream::pos_type( 0 ) ) { // file beginning
+        // First header: list of scalars, one by line
+        fout << "# " << 1 << " time" << endl;
+        j = 2;
+        for( k=0; k<s; k++ ) {
+            if( allScalars[k]->allowed_ ) {
+                fout << "# " << j << " " << allScalars[k]->name_ << endl;
+                j++;
+                if( ! allScalars[k]->secondname_.empty() ) {
+                    fout << "# " << j << " " << allScalars[k]->secondname_ << endl;
+                    j++;
                 }
-                fout << endl;
             }
-            // Each requested timestep, the following writes the values of the scalars
-            fout << setw( precision+10 ) << itime/res_time;
-            for( k=0; k<s; k++ ) {
-                if( allScalars[k]->allowed_ ) {
-                    fout << setw( allScalars[k]->width_ ) << ( double )*allScalars[k];
-                    if( ! allScalars[k]->secondname_.empty() ) {
-                        fout << setw( allScalars[k]->width_ ) << ( int )*static_cast<Scalar_value_location *>( allScalars[k] );
-                    }
+        }
+        // Second header: list of scalars, but all in one line
+        fout << "#\n#" << setw( precision+9 ) << "time";
+        for( k=0; k<s; k++ ) {
+            if( allScalars[k]->allowed_ ) {
+                fout << setw( allScalars[k]->width_ ) << allScalars[k]->name_;
+                if( ! allScalars[k]->secondname_.empty() ) {
+                    fout << setw( allScalars[k]->width_ ) << allScalars[k]->secondname_;
                 }
             }
-            fout << endl;
-            
         }
-        
-    } // if smpi->isMaster
-    
-    latest_timestep = itime;
+        fout << endl;
+    }
+    // Each requested timestep, the following writes the values of the scalars
+    fout << setw( precision+10 ) << timestep/res_time;
+    for( k=0; k<s; k++ ) {
+        if( allScalars[k]->allowed_ ) {
+            fout << setw( allScalars[k]->width_ ) << ( double )*allScalars[k];
+            if( ! allScalars[k]->secondname_.empty() ) {
+                fout << setw( allScalars[k]->width_ ) << ( int )*static_cast<Scalar_value_location *>( allScalars[k] );
+            }
+        }
+    }
+    fout << endl;
     
-} // END write
+} // END writeScalars
 
 
 //! Compute the various scalars when requested
@@ -2,6 +2,7 @@
 #define DIAGNOSTICSCALAR_H
 
 #include <fstream>
+#include <mpi.h>
 
 #include "Diagnostic.h"
 
@@ -137,6 +138,9 @@ public :
     //! Compute the various scalars when requested
     void compute( Patch *patch, int timestep );
     
+    //! Completes the pending MPI reductions (if wait is false, only if they already finished), and writes their result
+    void finishReduction( bool wait );
+    
     //! Latest timestep dumped
     int latest_timestep;
     
@@ -179,6 +183,20 @@ private :
     //! List of scalar values to be MAXLOCed by MPI
     std::vector<val_index> values_MAXLOC;
     
+    //! Copies of the scalar values being reduced by MPI while the simulation goes on
+    std::vector<double> reduced_SUM;
+    std::vector<val_index> reduced_MINLOC, reduced_MAXLOC;
+    
+    //! Requests of the pending MPI reductions, and their timestep
+    std::vector<MPI_Request> reduction_requests;
+    int reduction_timestep;
+    
+    //! Calculate the scalars that derive from the reduced ones (only by MPI master)
+    void completeScalars( int timestep );
+    
+    //! Write one line of scalars to the file (only by MPI master)
+    void writeScalars( int timestep );
+    
     //! Volume of a cell (copied from params)
     double cell_volume;
     
@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include "ParticleData.h"
+#include "ParticleFunction.h"
 #include "PeekAtSpecies.h"
 #include "DiagnosticTrack.h"
 #include "VectorPatch.h"
@@ -53,16 +54,21 @@ DiagnosticTrack::DiagnosticTrack( Params &params, SmileiMPI *smpi, VectorPatch &
     // Get parameter "filter" which gives a python function to select particles
     filter = PyTools::extract_py( "filter", "DiagTrackParticles", iDiagTrackParticles );
     has_filter = ( filter != Py_None );
+    compiled_filter = NULL;
     if( has_filter ) {
+        // Try to compile the filter so that it runs without python
+        compiled_filter = ParticleFunction::create( filter, { vecPatches( 0 )->vecSpecies[speciesId_]->particles }, true );
+        if( ! compiled_filter ) {
 #ifdef SMILEI_USE_NUMPY
-        PyTools::setIteration( 0 );
-        // Test the filter with temporary, "fake" particles
-        name << " filter:";
-        bool *dummy = NULL;
-        ParticleData test( nDim_particle, filter, name.str(), dummy );
+            PyTools::setIteration( 0 );
+            // Test the filter with temporary, "fake" particles
+            name << " filter:";
+            bool *dummy = NULL;
+            ParticleData test( nDim_particle, filter, name.str(), dummy );
 #else
-        ERROR( name.str() << " with a filter requires the numpy package" );
+            ERROR( name.str() << " with a filter requires the numpy package (or a filter that can be compiled)" );
 #endif
+        }
     }
     
     // Get the parameter "attributes": a list of attribute name that must be written
@@ -167,6 +173,7 @@ DiagnosticTrack::~DiagnosticTrack()
     delete flush_timeSelection;
     H5Pclose( transfer );
     Py_DECREF( filter );
+    delete compiled_filter;
 }
 
 
@@ -240,13 +247,47 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     
     hid_t momentum_group=0, position_group=0, iteration_group=0, particles_group=0, species_group=0;
     hid_t plist=0, file_space=0, mem_space=0;
+    
+    // A compiled filter selects the particles of all patches in parallel
+    if( compiled_filter ) {
+        #pragma omp single
+        patch_selection.resize( vecPatches.size() );
+        #pragma omp for schedule(runtime)
+        for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+            patch_selection[ipatch].resize( 0 );
+            Particles *p = vecPatches( ipatch )->vecSpecies[speciesId_]->particles;
+            unsigned int npart = p->size();
+            vector<double> selected( npart );
+            compiled_filter->valuesAt( p, npart, itime, selected.data() );
+            for( unsigned int i=0; i<npart; i++ ) {
+                if( selected[i] != 0. ) {
+                    patch_selection[ipatch].push_back( i );
+                }
+            }
+        }
+    }
+    
     #pragma omp master
     {
         // Obtain the particle partition of all the patches in this MPI
         nParticles_local = 0;
         patch_start.resize( vecPatches.size() );
         
-        if( has_filter ) {
+        if( compiled_filter ) {
+        
+            // Set the IDs of the particles not tracked before (ID==0)
+            for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
+                Particles *p = vecPatches( ipatch )->vecSpecies[speciesId_]->particles;
+                for( unsigned int i=0; i<patch_selection[ipatch].size(); i++ ) {
+                    if( p->id( patch_selection[ipatch][i] ) == 0 ) {
+                        p->id( patch_selection[ipatch][i] ) = ++latest_Id;
+                    }
+                }
+                patch_start[ipatch] = nParticles_local;
+                nParticles_local += patch_selection[ipatch].size();
+            }
+            
+        } else if( has_filter ) {
         
 #ifdef SMILEI_USE_NUMPY
             // Set a python variable "Main.iteration" to itime so that it can be accessed in the filter
@@ -414,7 +455,7 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
     // Weight
     if( write_weight ) {
         #pragma omp barrier
-        fill_buffer( vecPatches, nDim_particle+3, data_double );
+        fill_buffer<double, particle_real>( vecPatches, nDim_particle+3, data_double );
         #pragma omp master
         write_scalar( species_group, "weight", data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, plist, SMILEI_UNIT_DENSITY, nParticles_global );
     }
@@ -429,7 +470,7 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         for( unsigned int idim=0; idim<3; idim++ ) {
             if( write_momentum[idim] ) {
                 #pragma omp barrier
-                fill_buffer( vecPatches, nDim_particle+idim, data_double );
+                fill_buffer<double, particle_real>( vecPatches, nDim_particle+idim, data_double );
                 #pragma omp master
                 {
                     // Multiply by the mass to obtain an actual momentum
@@ -456,7 +497,7 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         for( unsigned int idim=0; idim<nDim_particle; idim++ ) {
             if( write_position[idim] ) {
                 #pragma omp barrier
-                fill_buffer( vecPatches, idim, data_double );
+                fill_buffer<double, particle_real>( vecPatches, idim, data_double );
                 #pragma omp master
                 write_component( position_group, xyz.substr( idim, 1 ).c_str(), data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, plist, SMILEI_UNIT_POSITION, nParticles_global );
             }
@@ -470,10 +511,10 @@ void DiagnosticTrack::run( SmileiMPI *smpi, VectorPatch &vecPatches, int itime,
         #pragma omp barrier
 // Position old exists in this case
 #ifdef  __DEBUG
-        fill_buffer( vecPatches, nDim_particle+3+3+1, data_double );
+        fill_buffer<double, particle_real>( vecPatches, nDim_particle+3+3+1, data_double );
 // Else, position old does not exist
 #else
-        fill_buffer( vecPatches, nDim_particle+3+1, data_double );
+        fill_buffer<double, particle_real>( vecPatches, nDim_particle+3+1, data_double );
 #endif
         #pragma omp master
         write_scalar( species_group, "chi", data_double[0], H5T_NATIVE_DOUBLE, file_space, mem_space, plist, SMILEI_UNIT_NONE, nParticles_global );
@@ -609,11 +650,11 @@ void DiagnosticTrack::setIDs( Particles &particles )
 }
 
 
-template<typename T>
+template<typename T, typename P>
 void DiagnosticTrack::fill_buffer( VectorPatch &vecPatches, unsigned int iprop, vector<T> &buffer )
 {
     unsigned int patch_nParticles, i, j, nPatches=vecPatches.size();
-    vector<T> *property = NULL;
+    aligned_vector<P> *property = NULL;
     
     if( has_filter ) {
         #pragma omp for schedule(runtime)
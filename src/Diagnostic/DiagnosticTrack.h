@@ -6,6 +6,7 @@
 class Patch;
 class Params;
 class SmileiMPI;
+class ParticleFunction;
 
 
 class DiagnosticTrack : public Diagnostic
@@ -36,8 +37,8 @@ public :
     //! Get disk footprint of current diagnostic
     uint64_t getDiskFootPrint( int istart, int istop, Patch *patch ) override;
     
-    //! Fills a buffer with the required particle property
-    template<typename T> void fill_buffer( VectorPatch &vecPatches, unsigned int iprop, std::vector<T> &buffer );
+    //! Fills a buffer with the required particle property (stored with type P)
+    template<typename T, typename P = T> void fill_buffer( VectorPatch &vecPatches, unsigned int iprop, std::vector<T> &buffer );
     
     //! Write a scalar dataset with the given buffer
     template<typename T> void write_scalar( hid_t, std::string, T &, hid_t, hid_t, hid_t, hid_t, unsigned int, unsigned int );
@@ -77,6 +78,9 @@ private :
     //! Tells whether this diag includes a particle filter
     PyObject *filter;
     
+    //! Compiled version of the filter (NULL if the filter must run in python)
+    ParticleFunction *compiled_filter;
+    
     //! Selection of the filtered particles in each patch
     std::vector<std::vector<unsigned int> > patch_selection;
     
@@ -13,7 +13,6 @@ void Histogram::digitize( Species *s,
                           SimWindow *simWindow )
 {
     unsigned int ipart, npart=s->particles->size();
-    int ind;
     
     for( unsigned int iaxis=0 ; iaxis < axes.size() ; iaxis++ ) {
     
@@ -42,40 +41,31 @@ void Histogram::digitize( Species *s,
         
         // loop again on the particles and calculate the index
         // This is separated in two cases: edge_inclusive and edge_exclusive
+        // The loops are branchless so that they vectorize. Discarded particles keep a negative index.
+        double actual_min = axes[iaxis]->actual_min;
+        double coeff = axes[iaxis]->coeff;
+        double nbins = axes[iaxis]->nbins;
         if( !axes[iaxis]->edge_inclusive ) { // if the particles out of the "box" must be excluded
         
+            #pragma omp simd
             for( ipart = 0 ; ipart < npart ; ipart++ ) {
-                // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
                 // calculate index
-                ind = floor( ( double_buffer[ipart]-axes[iaxis]->actual_min ) * axes[iaxis]->coeff );
-                // index valid only if in the "box"
-                if( ind >= 0  &&  ind < axes[iaxis]->nbins ) {
-                    int_buffer[ipart] += ind;
-                } else {
-                    int_buffer[ipart] = -1;    // discard particle
-                }
+                double x = floor( ( double_buffer[ipart]-actual_min ) * coeff );
+                // index valid only if in the "box" and not already discarded
+                bool valid = int_buffer[ipart] >= 0 && x >= 0. && x < nbins;
+                int_buffer[ipart] = valid ? int_buffer[ipart] + ( int ) x : -1;
             }
             
         } else { // if the particles out of the "box" must be included
         
+            #pragma omp simd
             for( ipart = 0 ; ipart < npart ; ipart++ ) {
+                // calculate index, and move out-of-range indexes back into range
+                double x = floor( ( double_buffer[ipart]-actual_min ) * coeff );
+                x = x >= 0. ? x : 0.;
+                x = x > nbins-1. ? nbins-1. : x;
                 // skip already discarded particles
-                if( int_buffer[ipart] < 0 ) {
-                    continue;
-                }
-                // calculate index
-                ind = floor( ( double_buffer[ipart]-axes[iaxis]->actual_min ) * axes[iaxis]->coeff );
-                // move out-of-range indexes back into range
-                if( ind < 0 ) {
-                    ind = 0;
-                }
-                if( ind >= axes[iaxis]->nbins ) {
-                    ind = axes[iaxis]->nbins-1;
-                }
-                int_buffer[ipart] += ind;
+                int_buffer[ipart] = int_buffer[ipart] >= 0 ? int_buffer[ipart] + ( int ) x : int_buffer[ipart];
             }
             
         }
@@ -86,7 +76,8 @@ void Histogram::digitize( Species *s,
 void Histogram::distribute(
     std::vector<double> &double_buffer,
     std::vector<int>    &int_buffer,
-    std::vector<double> &output_array )
+    std::vector<double> &output_array,
+    bool shared )
 {
 
     unsigned int ipart, npart=double_buffer.size();
@@ -94,13 +85,23 @@ void Histogram::distribute(
     
     // Sum the data into the data_sum according to the indexes
     // ---------------------------------------------------------------
-    for( ipart = 0 ; ipart < npart ; ipart++ ) {
-        ind = int_buffer[ipart];
-        if( ind<0 ) {
-            continue;    // skip discarded particles
+    if( shared ) {
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            ind = int_buffer[ipart];
+            if( ind<0 ) {
+                continue;    // skip discarded particles
+            }
+            #pragma omp atomic
+            output_array[ind] += double_buffer[ipart];
+        }
+    } else {
+        for( ipart = 0 ; ipart < npart ; ipart++ ) {
+            ind = int_buffer[ipart];
+            if( ind<0 ) {
+                continue;    // skip discarded particles
+            }
+            output_array[ind] += double_buffer[ipart];
         }
-        #pragma omp atomic
-        output_array[ind] += double_buffer[ipart];
     }
     
 }
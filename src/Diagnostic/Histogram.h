@@ -4,6 +4,7 @@
 #include "PyTools.h"
 #include "Species.h"
 #include "ParticleData.h"
+#include "ParticleFunction.h"
 #include "Patch.h"
 #include "SimWindow.h"
 #include <algorithm>
@@ -54,8 +55,8 @@ public:
     void digitize( Species *, std::vector<double> &, std::vector<int> &, SimWindow * );
     //! Calculate the quantity of each particle to be summed in the histogram
     virtual void valuate( Species *, std::vector<double> &, std::vector<int> & ) {};
-    //! Add the contribution of each particle in the histogram
-    void distribute( std::vector<double> &, std::vector<int> &, std::vector<double> & );
+    //! Add the contribution of each particle in the histogram (atomically, unless the histogram is private to the thread)
+    void distribute( std::vector<double> &, std::vector<int> &, std::vector<double> &, bool shared = true );
     
     std::string deposited_quantity;
     
@@ -501,6 +502,27 @@ class HistogramAxis_chi : public HistogramAxis
         }
     };
 };
+class HistogramAxis_compiled : public HistogramAxis
+{
+public:
+    HistogramAxis_compiled( ParticleFunction *f ) :
+        HistogramAxis(),
+        function( f )
+    {
+    };
+    ~HistogramAxis_compiled()
+    {
+        delete function;
+    };
+private:
+    void digitize( Species *s, std::vector<double> &array, std::vector<int> &index, unsigned int npart, SimWindow *simWindow )
+    {
+        // The values of the particles excluded (index<0) are not used
+        function->valuesAt( s->particles, npart, 0, array.data() );
+    };
+    
+    ParticleFunction *function;
+};
 #ifdef SMILEI_USE_NUMPY
 class HistogramAxis_user_function : public HistogramAxis
 {
@@ -524,7 +546,7 @@ private:
             particleData.resize( npart );
             particleData.set( s->particles );
             // run the function
-            PyArrayObject *ret = ( PyArrayObject * )PyObject_CallFunctionObjArgs( function, particleData.get(), NULL );
+            PyArrayObject *ret = ParticleData::toDoubleArray( PyObject_CallFunctionObjArgs( function, particleData.get(), NULL ) );
             particleData.clear();
             // Copy the result to "array"
             double *arr = ( double * ) PyArray_GETPTR1( ret, 0 );
@@ -1072,6 +1094,27 @@ class Histogram_ekin_vx : public Histogram
     };
 };
 
+class Histogram_compiled : public Histogram
+{
+public:
+    Histogram_compiled( ParticleFunction *f ) :
+        Histogram(),
+        function( f )
+    {};
+    ~Histogram_compiled()
+    {
+        delete function;
+    };
+private:
+    void valuate( Species *s, std::vector<double> &array, std::vector<int> &index )
+    {
+        // The values of the particles excluded (index<0) are not used
+        function->valuesAt( s->particles, array.size(), 0, array.data() );
+    };
+    
+    ParticleFunction *function;
+};
+
 #ifdef SMILEI_USE_NUMPY
 class Histogram_user_function : public Histogram
 {
@@ -1095,7 +1138,7 @@ private:
             particleData.resize( npart );
             particleData.set( s->particles );
             // run the function
-            PyArrayObject *ret = ( PyArrayObject * )PyObject_CallFunctionObjArgs( function, particleData.get(), NULL );
+            PyArrayObject *ret = ParticleData::toDoubleArray( PyObject_CallFunctionObjArgs( function, particleData.get(), NULL ) );
             particleData.clear();
             // Copy the result to "array"
             double *arr = ( double * ) PyArray_GETPTR1( ret, 0 );
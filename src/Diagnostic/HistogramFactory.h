@@ -24,6 +24,12 @@ public:
     
         Histogram *histogram;
         std::string deposited_quantity = "";
+        
+        // Particles of all species, to know which attributes user functions may use
+        std::vector<Particles *> particles;
+        for( unsigned int ispec=0 ; ispec < species.size() ; ispec++ ) {
+            particles.push_back( patch->vecSpecies[species[ispec]]->particles );
+        }
         std::ostringstream deposited_quantityName( "" );
         deposited_quantityName << errorPrefix << ": parameter `deposited_quantity`";
         std::string deposited_quantityPrefix = deposited_quantityName.str();
@@ -79,7 +85,13 @@ public:
             histogram->deposited_quantity = deposited_quantity;
             Py_DECREF( deposited_quantity_object );
             
-            // If numpy supported, also accept deposited_quantity = any function
+            // Accept deposited_quantity = any function, compiled if possible
+        } else if( ParticleFunction *f = ParticleFunction::create( deposited_quantity_object, particles, false ) ) {
+            histogram = new Histogram_compiled( f );
+            histogram->deposited_quantity = "user_function";
+            Py_DECREF( deposited_quantity_object );
+            
+            // Otherwise, if numpy supported, the function runs in python
         } else {
 #ifdef SMILEI_USE_NUMPY
             // Test the function with temporary, "fake" particles
@@ -116,6 +128,7 @@ public:
             
             // Try to extract first element: type
             PyObject *type_object = PySequence_Fast_GET_ITEM( seq, 0 );
+            ParticleFunction *compiled_axis = NULL;
             if( PyTools::convert( type_object, type ) ) {
                 if( type.substr( 0, 13 ) == "user_function" ) {
                     ERROR( errorPrefix << ", axis #" << iaxis << ": type " << type << " unknown" );
@@ -124,20 +137,23 @@ public:
                     if( type == excluded_axes[i] ) {
                         ERROR( errorPrefix << ", axis #" << iaxis << ": type " << type << " unknown" );
                     }
-                // If numpy supported, also accept type = any function
+                // Also accept type = any function, compiled if possible or if numpy supported
             } else {
                 std::ostringstream typePrefix( "" );
                 typePrefix << errorPrefix << ", axis #" << iaxis << ": type";
+                compiled_axis = ParticleFunction::create( type_object, particles, false );
+                if( ! compiled_axis ) {
 #ifdef SMILEI_USE_NUMPY
-                // Test the function with temporary, "fake" particles
-                double *dummy = NULL;
-                ParticleData test( params.nDim_particle, type_object, typePrefix.str(), dummy );
+                    // Test the function with temporary, "fake" particles
+                    double *dummy = NULL;
+                    ParticleData test( params.nDim_particle, type_object, typePrefix.str(), dummy );
+#else
+                    ERROR( errorPrefix << ", axis #" << iaxis << ": First item must be a string (axis type)" );
+#endif
+                }
                 std::ostringstream t( "" );
                 t << "user_function" << iaxis;
                 type = t.str();
-#else
-                ERROR( errorPrefix << ", axis #" << iaxis << ": First item must be a string (axis type)" );
-#endif
             }
             
             // Try to extract second element: axis min
@@ -243,6 +259,9 @@ public:
                     }
                 axis = new HistogramAxis_chi();
             }
+            else if( compiled_axis ) {
+                axis = new HistogramAxis_compiled( compiled_axis );
+            }
 #ifdef SMILEI_USE_NUMPY
             else if( type.substr( 0, 13 ) == "user_function" ) {
                 axis = new HistogramAxis_user_function( type_object );
@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <iostream>
+#include <utility>
 
 #include "Params.h"
 #include "Species.h"
@@ -432,6 +433,66 @@ void ElectroMagn::incrementAvgField( Field *field, Field *field_avg )
 
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Pipelined conjugate gradient (Chronopoulos & Gear): w = A*r
+//   the stencils of compute_Ap (p -> Ap) are applied to r -> w
+// ---------------------------------------------------------------------------------------------------------------------
+void ElectroMagn::compute_Ar( Patch *patch )
+{
+    std::swap( p_, r_ );
+    std::swap( Ap_, w_ );
+    compute_Ap( patch );
+    std::swap( Ap_, w_ );
+    std::swap( p_, r_ );
+}
+
+void ElectroMagn::compute_Ar_relativistic_Poisson( Patch *patch, double gamma_mean )
+{
+    std::swap( p_, r_ );
+    std::swap( Ap_, w_ );
+    compute_Ap_relativistic_Poisson( patch, gamma_mean );
+    std::swap( Ap_, w_ );
+    std::swap( p_, r_ );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Pipelined conjugate gradient: scalar product w.r accounting only on real nodes (as compute_r)
+// ---------------------------------------------------------------------------------------------------------------------
+double ElectroMagn::compute_wr()
+{
+    unsigned int ndim = index_min_p_.size();
+    unsigned int ny = ndim>1 ? r_->dims_[1] : 1;
+    unsigned int nz = ndim>2 ? r_->dims_[2] : 1;
+    unsigned int jmin = ndim>1 ? index_min_p_[1] : 0, jmax = ndim>1 ? index_max_p_[1] : 0;
+    unsigned int kmin = ndim>2 ? index_min_p_[2] : 0, kmax = ndim>2 ? index_max_p_[2] : 0;
+    
+    double w_dot_r_local( 0. );
+    for( unsigned int i=index_min_p_[0]; i<=index_max_p_[0]; i++ ) {
+        for( unsigned int j=jmin; j<=jmax; j++ ) {
+            for( unsigned int k=kmin; k<=kmax; k++ ) {
+                unsigned int idx = ( i*ny+j )*nz+k;
+                w_dot_r_local += ( *w_ )( idx )*( *r_ )( idx );
+            }
+        }
+    }
+    return w_dot_r_local;
+} // compute_wr
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Pipelined conjugate gradient: new direction p, its image Ap = A*p (by recurrence), new potential and residual
+// ---------------------------------------------------------------------------------------------------------------------
+void ElectroMagn::update_pipelined_CG( double alpha, double beta )
+{
+    for( unsigned int i=0; i<r_->globalDims_; i++ ) {
+        ( *p_ )( i )   = ( *r_ )( i ) + beta * ( *p_ )( i );
+        ( *Ap_ )( i )  = ( *w_ )( i ) + beta * ( *Ap_ )( i );
+        ( *phi_ )( i ) += alpha * ( *p_ )( i );
+        ( *r_ )( i )   -= alpha * ( *Ap_ )( i );
+    }
+} // update_pipelined_CG
+
+
+
 void ElectroMagn::laserDisabled()
 {
     if( emBoundCond.size() && emBoundCond[0] ) {
@@ -259,6 +259,13 @@ public:
     virtual double compute_pAp() = 0;
     virtual void update_pand_r( double r_dot_r, double p_dot_Ap ) = 0;
     virtual void update_p( double rnew_dot_rnew, double r_dot_r ) = 0;
+    //! Pipelined conjugate gradient: w = A*r, using the stencil of compute_Ap
+    void compute_Ar( Patch *patch );
+    void compute_Ar_relativistic_Poisson( Patch *patch, double gamma_mean );
+    //! Pipelined conjugate gradient: scalar product w.r on the real nodes
+    double compute_wr();
+    //! Pipelined conjugate gradient: p = r + beta*p, Ap = w + beta*Ap, phi += alpha*p, r -= alpha*Ap
+    void update_pipelined_CG( double alpha, double beta );
     virtual void initE( Patch *patch ) = 0;
     virtual void initE_relativistic_Poisson( Patch *patch, double gamma_mean ) = 0;
     virtual void initB_relativistic_Poisson( Patch *patch, double gamma_mean ) = 0;
@@ -290,6 +297,8 @@ public:
     Field *r_;
     Field *p_;
     Field *Ap_;
+    //! A*r, used by the pipelined conjugate gradient
+    Field *w_;
 
     cField *phi_AM_;
     cField *r_AM_;
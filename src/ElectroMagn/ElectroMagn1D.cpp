@@ -247,6 +247,7 @@ void ElectroMagn1D::initPoisson( Patch *patch )
     r_   = new Field1D( dimPrim );  // residual vector
     p_   = new Field1D( dimPrim );  // direction vector
     Ap_  = new Field1D( dimPrim );  // A*p vector
+    w_   = new Field1D( dimPrim );  // A*r vector (pipelined CG)
     
     // double       dx_sq          = dx*dx;
     
@@ -366,6 +367,7 @@ void ElectroMagn1D::initE( Patch *patch )
     delete r_;
     delete p_;
     delete Ap_;
+    delete w_;
     
 } // initE
 
@@ -400,6 +402,7 @@ void ElectroMagn1D::initE_relativistic_Poisson( Patch *patch, double gamma_mean
     delete r_;
     delete p_;
     delete Ap_;
+    delete w_;
     
 } // initE_relativistic_Poisson
 
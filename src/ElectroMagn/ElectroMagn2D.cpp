@@ -308,6 +308,7 @@ void ElectroMagn2D::initPoisson( Patch *patch )
     r_   = new Field2D( dimPrim );  // residual vector
     p_   = new Field2D( dimPrim );  // direction vector
     Ap_  = new Field2D( dimPrim );  // A*p vector
+    w_   = new Field2D( dimPrim );  // A*r vector (pipelined CG)
     
     
     for( unsigned int i=0; i<nx_p; i++ ) {
@@ -535,6 +536,7 @@ void ElectroMagn2D::initE( Patch *patch )
     delete r_;
     delete p_;
     delete Ap_;
+    delete w_;
     
 } // initE
 
@@ -606,6 +608,7 @@ void ElectroMagn2D::initE_relativistic_Poisson( Patch *patch, double gamma_mean
     delete r_;
     delete p_;
     delete Ap_;
+    delete w_;
     
 } // initE_relativistic_Poisson
 
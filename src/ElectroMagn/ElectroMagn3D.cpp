@@ -315,6 +315,7 @@ void ElectroMagn3D::initPoisson( Patch *patch )
     r_   = new Field3D( dimPrim );  // residual vector
     p_   = new Field3D( dimPrim );  // direction vector
     Ap_  = new Field3D( dimPrim );  // A*p vector
+    w_   = new Field3D( dimPrim );  // A*r vector (pipelined CG)
     
     
     for( unsigned int i=0; i<nx_p; i++ ) {
@@ -613,6 +614,7 @@ void ElectroMagn3D::initE( Patch *patch )
     delete r_;
     delete p_;
     delete Ap_;
+    delete w_;
     
 } // initE
 
@@ -740,6 +742,7 @@ void ElectroMagn3D::initE_relativistic_Poisson( Patch *patch, double gamma_mean
     delete r_;
     delete p_;
     delete Ap_;
+    delete w_;
     
 } // initE_relativistic_Poisson
 
@@ -243,10 +243,12 @@ LaserProfileSeparable::LaserProfileSeparable(
     chirpProfile_( chirpProfile ),
     spaceProfile_( spaceProfile ),
     phaseProfile_( phaseProfile ),
-    delay_phase_( delay_phase )
+    delay_phase_( delay_phase ),
+    amplitude_time( std::nan( "" ) )
 {
     space_envelope = NULL;
     phase = NULL;
+    amplitude = NULL;
 }
 // Separable laser profile cloning constructor
 LaserProfileSeparable::LaserProfileSeparable( LaserProfileSeparable *lp ) :
@@ -256,10 +258,12 @@ LaserProfileSeparable::LaserProfileSeparable( LaserProfileSeparable *lp ) :
     chirpProfile_( new Profile( lp->chirpProfile_ ) ),
     spaceProfile_( new Profile( lp->spaceProfile_ ) ),
     phaseProfile_( new Profile( lp->phaseProfile_ ) ),
-    delay_phase_( lp->delay_phase_ )
+    delay_phase_( lp->delay_phase_ ),
+    amplitude_time( std::nan( "" ) )
 {
     space_envelope = NULL;
     phase = NULL;
+    amplitude = NULL;
 }
 // Separable laser profile destructor
 LaserProfileSeparable::~LaserProfileSeparable()
@@ -283,6 +287,9 @@ LaserProfileSeparable::~LaserProfileSeparable()
     if( phase ) {
         delete phase;
     }
+    if( amplitude ) {
+        delete amplitude;
+    }
 }
 
 
@@ -320,6 +327,8 @@ void LaserProfileSeparable::createFields( Params &params, Patch *patch )
     //Create laser fields
     space_envelope = new Field2D( dim );
     phase          = new Field2D( dim );
+    amplitude      = new Field2D( dim );
+    time_envelope.resize( amplitude->globalDims_ );
 }
 
 void LaserProfileSeparable::initFields( Params &params, Patch *patch )
@@ -393,16 +402,55 @@ void LaserProfileSeparable::initFields( Params &params, Patch *patch )
 }
 
 // Amplitude of a separable laser profile
+// The amplitudes of all the points of the patch are computed at the first call of each time step
 double LaserProfileSeparable::getAmplitude( std::vector<double> pos, double t, int j, int k )
 {
-    double amp;
-    #pragma omp critical
-    {
-        double omega = omega_ * chirpProfile_->valueAt( t );
-        double phi = ( *phase )( j, k );
-        amp = timeProfile_->valueAt( t-( phi+delay_phase_ )/omega ) * ( *space_envelope )( j, k ) * sin( omega*t - phi );
+    if( t != amplitude_time ) {
+        computeAmplitudes( t );
     }
-    return amp;
+    return ( *amplitude )( j, k );
+}
+
+// Table of amplitudes of a separable laser profile at time t
+// The time profile is evaluated once for each distinct phase (usually once per time step), and only user-defined
+// python profiles require a critical section, entered once per patch
+void LaserProfileSeparable::computeAmplitudes( double t )
+{
+    unsigned int n = amplitude->globalDims_;
+    double *phi = phase->data();
+    double *env = space_envelope->data();
+    double *amp = amplitude->data();
+    double *tenv = &time_envelope[0];
+    
+    double omega;
+    if( chirpProfile_->usesPython() || timeProfile_->usesPython() ) {
+        #pragma omp critical
+        omega = computeTimeEnvelope( t, phi, tenv, n );
+    } else {
+        omega = computeTimeEnvelope( t, phi, tenv, n );
+    }
+    
+    #pragma omp simd
+    for( unsigned int i=0; i<n; i++ ) {
+        amp[i] = tenv[i] * env[i] * sin( omega*t - phi[i] );
+    }
+    amplitude_time = t;
+}
+
+// Values of the time profile for n points of phases phi, at time t (returns the chirped frequency)
+double LaserProfileSeparable::computeTimeEnvelope( double t, double *phi, double *tenv, unsigned int n )
+{
+    double omega = omega_ * chirpProfile_->valueAt( t );
+    double previous_phi = std::nan( "" );
+    double previous_tenv = 0.;
+    for( unsigned int i=0; i<n; i++ ) {
+        if( phi[i] != previous_phi ) {
+            previous_phi = phi[i];
+            previous_tenv = timeProfile_->valueAt( t-( phi[i]+delay_phase_ )/omega );
+        }
+        tenv[i] = previous_tenv;
+    }
+    return omega;
 }
 
 //Destructor
@@ -516,8 +564,10 @@ double LaserProfileFile::getAmplitude( std::vector<double> pos, double t, int j,
     for( unsigned int i=0; i<n; i++ ) {
         amp += ( *magnitude )( j, k, i ) * sin( omega[i] * t + ( *phase )( j, k, i ) );
     }
-    #pragma omp critical
-    {
+    if( extraProfile->usesPython() ) {
+        #pragma omp critical
+        amp *= extraProfile->valueAt( pos, t );
+    } else {
         amp *= extraProfile->valueAt( pos, t );
     }
     return amp;
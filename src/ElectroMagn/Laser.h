@@ -109,11 +109,22 @@ public:
     double getAmplitude( std::vector<double> pos, double t, int j, int k );
 protected:
     Field *space_envelope, *phase;
+    //! Amplitudes of all the points of the patch at time amplitude_time
+    Field *amplitude;
 private:
+    //! Compute the table of amplitudes at time t
+    void computeAmplitudes( double t );
+    //! Compute the time profile of n points of phases phi at time t, and return the chirped frequency
+    double computeTimeEnvelope( double t, double *phi, double *tenv, unsigned int n );
+    
     bool primal_;
     double omega_;
     Profile *timeProfile_, *chirpProfile_, *spaceProfile_, *phaseProfile_;
     double delay_phase_;
+    //! Time of the amplitudes stored in the table (NaN if not computed yet)
+    double amplitude_time;
+    //! Values of the time profile of all the points at time amplitude_time
+    std::vector<double> time_envelope;
 };
 
 // Laser profile for non-separable space and time
@@ -129,8 +140,12 @@ public:
     inline double getAmplitude( std::vector<double> pos, double t, int j, int k )
     {
         double amp;
-        #pragma omp critical
-        amp = spaceAndTimeProfile_->valueAt( pos, t );
+        if( spaceAndTimeProfile_->usesPython() ) {
+            #pragma omp critical
+            amp = spaceAndTimeProfile_->valueAt( pos, t );
+        } else {
+            amp = spaceAndTimeProfile_->valueAt( pos, t );
+        }
         return amp;
     }
 private:
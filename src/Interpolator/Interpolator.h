@@ -24,6 +24,16 @@ public:
     virtual void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) = 0;
     virtual void oneField( Field *field, Particles &particles, int *istart, int *iend, double *FieldLoc ) =0;
     
+    //! Number of nodes of the interpolation stencil along each dimension (0 if stencils are not available)
+    virtual unsigned int stencilSize()
+    {
+        return 0;
+    };
+    
+    //! Interpolation stencil along dimension idim of a point at the given position, on the primal or dual grid:
+    //! index of the first node in the patch arrays, and the stencilSize() weights
+    virtual void stencil( unsigned int idim, double position, bool dual, int &first, double *weights ) {};
+    
     virtual void fieldsAndEnvelope( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref = 0 )
     {
         ERROR( "Envelope not implemented with this geometry and this order" );
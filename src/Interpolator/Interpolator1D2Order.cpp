@@ -106,6 +106,31 @@ void Interpolator1D2Order::oneField( Field *field, Particles &particles, int *is
     }
 }
 
+// Interpolation stencil of a point along one dimension (used by the probes to cache their stencils)
+void Interpolator1D2Order::stencil( unsigned int idim, double position, bool dual, int &first, double *weights )
+{
+    double xn = position*dx_inv_;
+    
+    // Index of the central node and normalized distance to it
+    int i;
+    double delta;
+    if( dual ) {
+        i = round( xn+0.5 );
+        delta = xn - ( double )i + 0.5;
+    } else {
+        i = round( xn );
+        delta = xn - ( double )i;
+    }
+    double delta2 = delta*delta;
+    
+    weights[0] = 0.5 * ( delta2-delta+0.25 );
+    weights[1] = 0.75 - delta2;
+    weights[2] = 0.5 * ( delta2+delta+0.25 );
+    
+    // First node of the stencil
+    first = i - 1 - ( int )index_domain_begin;
+}
+
 void Interpolator1D2Order::fieldsWrapper( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
 {
     std::vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
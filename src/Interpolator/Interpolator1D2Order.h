@@ -21,6 +21,12 @@ public:
     void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) override final;
     void oneField( Field *field, Particles &particles, int *istart, int *iend, double *FieldLoc ) override final;
     
+    unsigned int stencilSize() override final
+    {
+        return 3;
+    };
+    void stencil( unsigned int idim, double position, bool dual, int &first, double *weights ) override final;
+    
     inline double compute( double *coeff, Field1D *f, int idx )
     {
         double interp_res =  coeff[0] * ( *f )( idx-1 )   + coeff[1] * ( *f )( idx )   + coeff[2] * ( *f )( idx+1 );
@@ -120,6 +120,35 @@ void Interpolator1D4Order::oneField( Field *field, Particles &particles, int *is
     }
 }
 
+// Interpolation stencil of a point along one dimension (used by the probes to cache their stencils)
+void Interpolator1D4Order::stencil( unsigned int idim, double position, bool dual, int &first, double *weights )
+{
+    double xn = position*dx_inv_;
+    
+    // Index of the central node and normalized distance to it
+    int i;
+    double delta;
+    if( dual ) {
+        i = round( xn+0.5 );
+        delta = xn - ( double )i + 0.5;
+    } else {
+        i = round( xn );
+        delta = xn - ( double )i;
+    }
+    double delta2 = delta*delta;
+    double delta3 = delta2*delta;
+    double delta4 = delta3*delta;
+    
+    weights[0] = dble_1_ov_384   - dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 - dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+    weights[1] = dble_19_ov_96   - dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  + dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
+    weights[2] = dble_115_ov_192 - dble_5_ov_8   * delta2 + dble_1_ov_4 * delta4;
+    weights[3] = dble_19_ov_96   + dble_11_ov_24 * delta  + dble_1_ov_4 * delta2  - dble_1_ov_6  * delta3 - dble_1_ov_6  * delta4;
+    weights[4] = dble_1_ov_384   + dble_1_ov_48  * delta  + dble_1_ov_16 * delta2 + dble_1_ov_12 * delta3 + dble_1_ov_24 * delta4;
+    
+    // First node of the stencil
+    first = i - 2 - ( int )index_domain_begin;
+}
+
 void Interpolator1D4Order::fieldsWrapper( ElectroMagn *EMfields, Particles &particles, SmileiMPI *smpi, int *istart, int *iend, int ithread, int ipart_ref )
 {
     std::vector<double> *Epart = &( smpi->dynamics_Epart[ithread] );
@@ -22,6 +22,12 @@ public:
     void fieldsSelection( ElectroMagn *EMfields, Particles &particles, double *buffer, int offset, std::vector<unsigned int> *selection ) override final;
     void oneField( Field *field, Particles &particles, int *istart, int *iend, double *FieldLoc ) override final;
     
+    unsigned int stencilSize() override final
+    {
+        return 3;
+    };
+    void stencil( unsigned int idim, double position, bool dual, int &first, double *weights ) override final;
+    
     inline double compute( double *coeffx, double *coeffy, Field2D *f, int idx, int idy )
     {
         double interp_res( 0. );
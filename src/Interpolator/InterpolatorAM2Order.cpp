@@ -46,7 +46,7 @@ void InterpolatorAM2Order::fields( ElectroMagn *EMfields, Particles &particles,
     double xpn = particles.position( 0, ipart ) * dl_inv_;
     double r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
     double rpn = r * dr_inv_;
-    exp_m_theta = ( particles.position( 1, ipart ) - Icpx * particles.position( 2, ipart ) ) / r ; //exp(-i theta)
+    exp_m_theta = ( ( double )particles.position( 1, ipart ) - Icpx * ( double )particles.position( 2, ipart ) ) / r ; //exp(-i theta)
     complex<double> exp_mm_theta = 1. ;                                                          //exp(-i m theta)
     // Calculate coeffs
     coeffs( xpn, rpn );
@@ -145,7 +145,7 @@ void InterpolatorAM2Order::fieldsAndCurrents( ElectroMagn *EMfields, Particles &
     ( *RhoLoc ) = std::real( compute( &coeffxp_[1], &coeffyp_[1], Rho, ip_, jp_ ) );
    
     if (r > 0){ 
-        exp_m_theta = ( particles.position( 1, ipart ) - Icpx * particles.position( 2, ipart ) ) / r ;
+        exp_m_theta = ( ( double )particles.position( 1, ipart ) - Icpx * ( double )particles.position( 2, ipart ) ) / r ;
     } else {
         exp_m_theta = 1. ;
     }
@@ -203,7 +203,7 @@ void InterpolatorAM2Order::oneField( Field *field, Particles &particles, int *is
         double r = sqrt( particles.position( 1, ipart )*particles.position( 1, ipart )+particles.position( 2, ipart )*particles.position( 2, ipart ) ) ;
         double rpn = r * dr_inv_;
         if (r > 0){ 
-            exp_m_theta = ( particles.position( 1, ipart ) - Icpx * particles.position( 2, ipart ) ) / r ;
+            exp_m_theta = ( ( double )particles.position( 1, ipart ) - Icpx * ( double )particles.position( 2, ipart ) ) / r ;
         } else {
             exp_m_theta = 1. ;
         }
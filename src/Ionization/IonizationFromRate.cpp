@@ -46,7 +46,7 @@ void IonizationFromRate::operator()( Particles *particles, unsigned int ipart_mi
         particleData.startAt( ipart_min );
         PyTools::setIteration( itime );
         particleData.set( particles );
-        ret = ( PyArrayObject * )PyObject_CallFunctionObjArgs( ionization_rate, particleData.get(), NULL );
+        ret = ParticleData::toDoubleArray( PyObject_CallFunctionObjArgs( ionization_rate, particleData.get(), NULL ) );
         PyTools::checkPyError();
         if( ret == NULL ) {
             ERROR( "ionization_rate profile has not provided a correct result" );
@@ -75,7 +75,7 @@ void IonizationFromRate::operator()( Particles *particles, unsigned int ipart_mi
         // Start of the Monte-Carlo routine  (At the moment, only 1 ionization per timestep is possible)
         // k_times will give the nb of ionization events
         k_times = 0;
-        double ran_p = patch->xorshift32() * patch->xorshift32_invmax;
+        double ran_p = patch->rand_->uniform();
         if( ran_p < 1.0 - exp( -rate[ipart-ipart_min]*dt ) ) {
             k_times        = 1;
         }
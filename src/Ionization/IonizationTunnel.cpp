@@ -87,7 +87,7 @@ void IonizationTunnel::operator()( Particles *particles, unsigned int ipart_min,
         invE = 1./E;
         factorJion = factorJion_0 * invE*invE;
         delta      = gamma_tunnel[Z]*invE;
-        ran_p = patch->xorshift32() * patch->xorshift32_invmax;
+        ran_p = patch->rand_->uniform();
         IonizRate_tunnel[Z] = beta_tunnel[Z] * exp( -delta*one_third + alpha_tunnel[Z]*log( delta ) );
         
         // Total ionization potential (used to compute the ionization current)
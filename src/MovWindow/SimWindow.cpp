@@ -310,6 +310,7 @@ void SimWindow::operate( VectorPatch &vecPatches, SmileiMPI *smpi, Params &param
                     // If new particles are required
                     if( patch_particle_created[ithread][j] ) {
                         for( unsigned int ispec=0 ; ispec<nSpecies ; ispec++ ) {
+                            mypatch->rand_->stream( mypatch->Hindex(), itime, Random::creation, ispec );
                             mypatch->vecSpecies[ispec]->createParticles( params.n_space, params, mypatch, 0 );
 
                             /*#ifdef _VECTO
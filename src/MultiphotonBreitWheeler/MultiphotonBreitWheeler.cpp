@@ -15,8 +15,9 @@
 // input: simulation parameters & Species index
 //! \param params simulation parameters
 //! \param species Species index
+//! \param rand random number generator of the patch
 // -----------------------------------------------------------------------------
-MultiphotonBreitWheeler::MultiphotonBreitWheeler( Params &params, Species *species )
+MultiphotonBreitWheeler::MultiphotonBreitWheeler( Params &params, Species *species, Random *rand )
 {
     // Dimension position
     n_dimensions_ = params.nDim_particle;
@@ -41,6 +42,7 @@ MultiphotonBreitWheeler::MultiphotonBreitWheeler( Params &params, Species *speci
     //! Threshold under which pair creation is not considered
     chiph_threashold = 1E-2;
     
+    rand_ = rand;
 }
 
 // -----------------------------------------------------------------------------
@@ -74,13 +76,13 @@ void MultiphotonBreitWheeler::compute_thread_chiph( Particles &particles,
     double gamma;
     
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
     
     // Optical depth for the Monte-Carlo process
-    double *chi = &( particles.chi( 0 ) );
+    particle_real *chi = &( particles.chi( 0 ) );
     
     // _______________________________________________________________
     // Computation
@@ -147,11 +149,11 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
     // Temporary value
     double temp;
     
-    // Time to event
-    double event_time;
+    // Time to event, for a pack of particles
+    double event_time[pack_size_];
     
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
@@ -168,10 +170,10 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
     // double* weight = &( particles.weight(0) );
     
     // Optical depth for the Monte-Carlo process
-    double *tau = &( particles.tau( 0 ) );
+    particle_real *tau = &( particles.tau( 0 ) );
     
     // Quantum parameter
-    double *photon_chi = &( particles.chi( 0 ) );
+    particle_real *photon_chi = &( particles.chi( 0 ) );
     
     // Photon id
     // uint64_t * id = &( particles.id(0));
@@ -199,30 +201,25 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
                                 ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
     }
     
-    // 2. Monte-Carlo process
-    //    No vectorized
-    for( int ipart=istart ; ipart<iend; ipart++ ) {
+    // 2. Monte-Carlo process, for packs of particles
+    for( int ipack=istart ; ipack<iend; ipack+=pack_size_ ) {
     
-        // If the photon has enough energy
-        // We also check that photon_chi > chiph_threshold,
-        // else photon_chi is too low to induce a decay
-        if( ( ( *gamma )[ipart] > 2. ) && ( photon_chi[ipart] > chiph_threashold ) ) {
-            // Init local variables
-            event_time = 0;
+        int npack = iend-ipack < pack_size_ ? iend-ipack : pack_size_;
+        
+        // 2.1 Photon decay under progress (vectorized)
+        //     event_time >= 0 if the final optical depth is reached
+        #pragma omp simd private( temp )
+        for( int i=0 ; i<npack; i++ ) {
+            int ipart = ipack+i;
             
-            // New even
-            // If tau[ipart] <= 0, this is a new process
-            if( tau[ipart] <= epsilon_tau_ ) {
-                // New final optical depth to reach for emision
-                while( tau[ipart] <= epsilon_tau_ ) {
-                    tau[ipart] = -log( 1.-Rand::uniform() );
-                }
-                
-            }
+            event_time[i] = -1.;
             
-            // Photon decay: emission under progress
-            // If epsilon_tau_ > 0
-            else if( tau[ipart] > epsilon_tau_ ) {
+            // If the photon has enough energy
+            // We also check that photon_chi > chiph_threshold,
+            // else photon_chi is too low to induce a decay
+            if( ( ( *gamma )[ipart] > 2. ) && ( photon_chi[ipart] > chiph_threashold )
+                    && ( tau[ipart] > epsilon_tau_ ) ) {
+                    
                 // from the cross section
                 temp = MultiphotonBreitWheelerTables.compute_dNBWdt( photon_chi[ipart], ( *gamma )[ipart] );
                 
@@ -230,38 +227,58 @@ void MultiphotonBreitWheeler::operator()( Particles &particles,
                 // If this time is above the remaining iteration time,
                 // There is a synchronization at the end of the pic iteration
                 // and the process continues at the next
-                event_time = std::min( tau[ipart]/temp, dt );
+                double time = std::min( tau[ipart]/temp, dt );
                 
                 // Update of the optical depth
-                tau[ipart] -= temp*event_time;
+                tau[ipart] -= temp*time;
                 
                 // If the final optical depth is reached
                 // The photon decays into pairs
                 if( tau[ipart] <= epsilon_tau_ ) {
+                    event_time[i] = time;
+                }
+            }
+        }
+        
+        // 2.2 New events and pair generation (scalar, the random numbers are drawn
+        //     in the order of the particles)
+        for( int i=0 ; i<npack; i++ ) {
+            int ipart = ipack+i;
+            
+            if( event_time[i] >= 0. ) {
+            
+                // Update of the position
+                // Move the photons
                 
-                    // Update of the position
-                    // Move the photons
-                    
 //#ifdef  __DEBUG
-//                    for ( int i = 0 ; i<n_dimensions_ ; i++ )
-//                        particles.position_old(i,ipart) = position[i][ipart];
+//                for ( int i = 0 ; i<n_dimensions_ ; i++ )
+//                    particles.position_old(i,ipart) = position[i][ipart];
 //#endif
-//                    for ( int i = 0 ; i<n_dimensions_ ; i++ )
-//                        position[i][ipart]     += event_time*momentum[i][ipart]/(*gamma)[ipart];
+//                for ( int i = 0 ; i<n_dimensions_ ; i++ )
+//                    position[i][ipart]     += event_time*momentum[i][ipart]/(*gamma)[ipart];
 
 
-                    // Generation of the pairs
-                    MultiphotonBreitWheeler::pair_emission( ipart,
-                                                            particles,
-                                                            ( *gamma )[ipart],
-                                                            dt - event_time,
-                                                            MultiphotonBreitWheelerTables );
-                                                            
-                                                            
-                    // Optical depth becomes negative meaning
-                    // that a new drawing is possible
-                    // at the next Monte-Carlo iteration
-                    tau[ipart] = -1.;
+                // Generation of the pairs
+                MultiphotonBreitWheeler::pair_emission( ipart,
+                                                        particles,
+                                                        ( *gamma )[ipart],
+                                                        dt - event_time[i],
+                                                        MultiphotonBreitWheelerTables );
+                                                        
+                                                        
+                // Optical depth becomes negative meaning
+                // that a new drawing is possible
+                // at the next Monte-Carlo iteration
+                tau[ipart] = -1.;
+            }
+            
+            // New event
+            // If tau[ipart] <= 0, this is a new process
+            else if( ( ( *gamma )[ipart] > 2. ) && ( photon_chi[ipart] > chiph_threashold )
+                     && ( tau[ipart] <= epsilon_tau_ ) ) {
+                // New final optical depth to reach for emision
+                while( tau[ipart] <= epsilon_tau_ ) {
+                    tau[ipart] = -log( 1.-rand_->uniform() );
                 }
             }
         }
@@ -304,7 +321,7 @@ void MultiphotonBreitWheeler::pair_emission( int ipart,
     inv_chiph_gammaph = ( gammaph-2. )/particles.chi( ipart );
     
     // Get the pair quantum parameters to compute the energy
-    chi = MultiphotonBreitWheelerTables.compute_pair_chi( particles.chi( ipart ) );
+    chi = MultiphotonBreitWheelerTables.compute_pair_chi( particles.chi( ipart ), rand_ );
     
     // pair propagation direction // direction of the photon
     for( k = 0 ; k<3 ; k++ ) {
@@ -398,7 +415,7 @@ void MultiphotonBreitWheeler::decayed_photon_cleaning(
 
     if( bmax[ibin] > bmin[ibin] ) {
         // Weight shortcut
-        double *weight = &( particles.weight( 0 ) );
+        particle_real *weight = &( particles.weight( 0 ) );
         
         // Index of the last existing photon (weight > 0)
         int last_photon_index;
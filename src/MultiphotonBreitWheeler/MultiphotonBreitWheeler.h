@@ -26,7 +26,7 @@ class MultiphotonBreitWheeler
 public:
 
     //! Creator for Radiation
-    MultiphotonBreitWheeler( Params &params, Species *species );
+    MultiphotonBreitWheeler( Params &params, Species *species, Random *rand );
     ~MultiphotonBreitWheeler();
     
     //! Overloading of () operator
@@ -58,7 +58,7 @@ public:
     //! \param By y component of the particle magnetic field
     //! \param Bz z component of the particle magnetic field
     //#pragma omp declare simd
-    double inline compute_chiph( double &kx, double &ky, double &kz,
+    double inline compute_chiph( double kx, double ky, double kz,
                                  double &gamma,
                                  double &Ex, double &Ey, double &Ez,
                                  double &Bx, double &By, double &Bz )
@@ -152,9 +152,15 @@ private:
     //! Inverse Normalized Schwinger Electric field
     double inv_norm_E_Schwinger_;
     
+    //! Random number generator of the patch
+    Random *rand_;
+    
     //! Espilon to check when tau is near 0
     const double epsilon_tau_ = 1e-100;
     
+    //! Number of particles treated together in the vectorized loops
+    static const int pack_size_ = 256;
+    
 };
 
 #endif
@@ -28,15 +28,17 @@ public:
     //! for the species ispec
     //! \param params Parameters
     //! \param species species object
+    //! \param rand random number generator of the patch
     //  --------------------------------------------------------------------
     static MultiphotonBreitWheeler *create( Params &params,
-                                            Species *species )
+                                            Species *species,
+                                            Random *rand )
     {
         MultiphotonBreitWheeler *Multiphoton_Breit_Wheeler_process = NULL;
         
         // Assign the correct Radiation model to Radiate
         if( !species->multiphoton_Breit_Wheeler[0].empty() ) {
-            Multiphoton_Breit_Wheeler_process = new MultiphotonBreitWheeler( params, species );
+            Multiphoton_Breit_Wheeler_process = new MultiphotonBreitWheeler( params, species, rand );
             if( params.Laser_Envelope_model & species->ponderomotive_dynamics ) {
                 ERROR( "Multiphoton Breit-Wheeler model is not yet implemented for species interacting with Laser Envelope model." );
             }
@@ -127,57 +127,6 @@ void MultiphotonBreitWheelerTables::initialization( Params &params )
 // PHYSICAL COMPUTATION
 // -----------------------------------------------------------------------------
 
-// -----------------------------------------------------------------------------
-//! Computation of the production rate of pairs per photon
-//! \param photon_chi photon quantum parameter
-//! \param gamma photon normalized energy
-// -----------------------------------------------------------------------------
-double MultiphotonBreitWheelerTables::compute_dNBWdt( double photon_chi, double gamma )
-{
-    // ________________________________________
-    // Parameters
-
-    // Log of the photon quantum parameter particle_chi
-    double logchiph;
-    double logchiphm;
-    double logchiphp;
-    // Index
-    int ichiph;
-    // final value
-    double dNBWdt;
-
-    // ________________________________________
-    // Computation
-
-    logchiph = log10( photon_chi );
-
-    // Lower index for interpolation in the table integfochi
-    ichiph = int( floor( ( logchiph-T_log10_chiph_min )
-                         *T_chiph_inv_delta ) );
-
-    // If photon_chi is below the lower bound of the table
-    // An asymptotic approximation is used
-    if( ichiph < 0 ) {
-        ichiph = 0;
-        dNBWdt = 0.46*exp( -8./( 3.*photon_chi ) );
-    }
-    // If photon_chi is above the upper bound of the table
-    // An asymptotic approximation is used
-    else if( ichiph >= T_dim-1 ) {
-        ichiph = T_dim-2;
-        dNBWdt = 0.38*pow( photon_chi, -1./3. );
-    } else {
-        // Upper and lower values for linear interpolation
-        logchiphm = ichiph*T_chiph_delta + T_log10_chiph_min;
-        logchiphp = logchiphm + T_chiph_delta;
-
-        // Interpolation
-        dNBWdt = ( T_table[ichiph+1]*fabs( logchiph-logchiphm ) +
-                   T_table[ichiph]*fabs( logchiphp - logchiph ) )*T_chiph_inv_delta;
-    }
-    return factor_dNBWdt*dNBWdt*photon_chi/gamma;
-}
-
 // -----------------------------------------------------------------------------
 //! Computation of the value T(photon_chi) using the approximated
 //! formula of Erber
@@ -241,8 +190,9 @@ double MultiphotonBreitWheelerTables::compute_integration_Ritus_dTdchi( double p
 //! the multiphoton Breit-Wheeler pair creation
 //
 //! \param photon_chi photon quantum parameter
+//! \param rand random number generator of the patch
 // -----------------------------------------------------------------------------
-double *MultiphotonBreitWheelerTables::compute_pair_chi( double photon_chi )
+double *MultiphotonBreitWheelerTables::compute_pair_chi( double photon_chi, Random *rand )
 {
     // Parameters
     double *chi = new double[2];
@@ -279,8 +229,8 @@ double *MultiphotonBreitWheelerTables::compute_pair_chi( double photon_chi )
     // Search of the index ichiph for photon_chi
     // ---------------------------------------
 
-    // First, we compute a random xip in [0,1[
-    xip = Rand::uniform();
+    // First, we compute a random xip in ]0,1[
+    xip = rand->uniform();
 
     // The array uses the symmetric properties of the T fonction,
     // Cases xip > or <= 0.5 are treated seperatly
@@ -302,8 +252,9 @@ double *MultiphotonBreitWheelerTables::compute_pair_chi( double photon_chi )
         ichipa = xip_chipa_dim-2;
     } else {
         // Search for the corresponding index ichipa for xip
-        ichipa = userFunctions::search_elem_in_array(
-                     &xip_table[ichiph*xip_chipa_dim], xipp, xip_chipa_dim );
+        ichipa = userFunctions::search_elem_in_guided_array(
+                     &xip_table[ichiph*xip_chipa_dim], xipp, xip_chipa_dim,
+                     &xip_guide_table[ichiph*xip_chipa_dim], xip_chipa_dim );
     }
 
     // Delta for the particle_chi dimension
@@ -744,6 +695,13 @@ void MultiphotonBreitWheelerTables::compute_xip_table( SmileiMPI *smpi )
 
     }
 
+    // Guide tables for the inversion of xip
+    xip_guide_table.resize( xip_chiph_dim*xip_chipa_dim );
+    for( int ichiph = 0 ; ichiph < xip_chiph_dim ; ichiph++ ) {
+        userFunctions::build_guide_table( &xip_table[ichiph*xip_chipa_dim], xip_chipa_dim,
+                                          &xip_guide_table[ichiph*xip_chipa_dim], xip_chipa_dim );
+    }
+
     t1 = MPI_Wtime();
     MESSAGE( "        done in " << ( t1 - t0 ) << "s" );
 
@@ -17,10 +17,12 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cmath>
 
 #include "Params.h"
 #include "H5.h"
 #include "userFunctions.h"
+#include "Random.h"
 
 //------------------------------------------------------------------------------
 //! MutliphotonBreitWheelerTables class: holds parameters, tables and
@@ -48,9 +50,39 @@ public:
     // ---------------------------------------------------------------------
     
     //! Computation of the production rate of pairs per photon
+    //! Inlined, with a direct index in the log-spaced table, so that it can be
+    //! used in vectorized loops
     //! \param photon_chi photon quantum parameter
     //! \param gamma photon normalized energy
-    double compute_dNBWdt( double photon_chi, double gamma );
+    double inline compute_dNBWdt( double photon_chi, double gamma )
+    {
+        double logchiph = log10( photon_chi );
+        
+        // Lower index for interpolation in the table T
+        int ichiph = int( floor( ( logchiph-T_log10_chiph_min )
+                                 *T_chiph_inv_delta ) );
+                                 
+        double dNBWdt;
+        // If photon_chi is below the lower bound of the table
+        // An asymptotic approximation is used
+        if( ichiph < 0 ) {
+            dNBWdt = 0.46*exp( -8./( 3.*photon_chi ) );
+        }
+        // If photon_chi is above the upper bound of the table
+        // An asymptotic approximation is used
+        else if( ichiph >= T_dim-1 ) {
+            dNBWdt = 0.38*pow( photon_chi, -1./3. );
+        } else {
+            // Upper and lower values for linear interpolation
+            double logchiphm = ichiph*T_chiph_delta + T_log10_chiph_min;
+            double logchiphp = logchiphm + T_chiph_delta;
+            
+            // Interpolation
+            dNBWdt = ( T_table[ichiph+1]*fabs( logchiph-logchiphm ) +
+                       T_table[ichiph]*fabs( logchiphp - logchiph ) )*T_chiph_inv_delta;
+        }
+        return factor_dNBWdt*dNBWdt*photon_chi/gamma;
+    }
     
     //! Computation of the value T(photon_chi) using the approximated
     //! formula of Erber
@@ -80,7 +112,8 @@ public:
     //! Computation of the electron and positron quantum parameters for
     //! the multiphoton Breit-Wheeler pair creation
     //! \param photon_chi photon quantum parameter
-    double *compute_pair_chi( double photon_chi );
+    //! \param rand random number generator of the patch
+    double *compute_pair_chi( double photon_chi, Random *rand );
     
     // ---------------------------------------------------------------------
     // TABLE COMPUTATION
@@ -205,6 +238,10 @@ private:
     //! This enables to compute the energy repartition between the electron and the positron
     std::vector<double> xip_table;
     
+    //! Guide tables of the rows of xip_table (see userFunctions::build_guide_table),
+    //! to find the interval of a random xip without a bijection
+    std::vector<int> xip_guide_table;
+    
     //! Minimum boundary for photon_chi in the table xip and xip_chipamin
     double xip_chiph_min;
     
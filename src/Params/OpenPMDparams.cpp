@@ -203,6 +203,13 @@ void OpenPMDparams::writeComponentAttributes( hid_t location, unsigned int unit_
     H5::attr( location, "unitSI", unitSI[unit_type] );
 }
 
+void OpenPMDparams::writeErrorBoundAttributes( hid_t location, unsigned int unit_type, double error_bound )
+{
+    // these are not openPMD
+    H5::attr( location, "errorBound", error_bound );
+    H5::attr( location, "errorBoundSI", error_bound * unitSI[unit_type] );
+}
+
 
 
 // WARNING: do not change the format. It is required for OpenPMD compatibility.
@@ -81,6 +81,9 @@ public:
     //! Write the attributes for a component
     void writeComponentAttributes( hid_t, unsigned int );
     
+    //! Write the error bound of a component reduced by lossy compression (not openPMD)
+    void writeErrorBoundAttributes( hid_t, unsigned int, double );
+    
     
 private:
     Params *params;
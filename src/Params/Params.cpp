@@ -19,35 +19,6 @@
 
 using namespace std;
 
-namespace Rand
-{
-std::random_device device;
-std::mt19937 gen( device() );
-
-std::uniform_real_distribution<double> uniform_distribution( 0., 1. );
-double uniform()
-{
-    return uniform_distribution( gen );
-}
-
-std::uniform_real_distribution<double> uniform_distribution1( 0., 1.-1e-11 );
-double uniform1()
-{
-    return uniform_distribution1( gen );
-}
-
-std::uniform_real_distribution<double> uniform_distribution2( -1., 1. );
-double uniform2()
-{
-    return uniform_distribution2( gen );
-}
-double normal( double stddev )
-{
-    std::normal_distribution<double> normal_distribution( 0., stddev );
-    return normal_distribution( gen );
-}
-}
-
 #define DO_EXPAND(VAL)  VAL ## 1
 #define EXPAND(VAL)     DO_EXPAND(VAL)
 #ifdef SMILEI_USE_NUMPY
@@ -209,14 +180,17 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         }
     }
     
-    // random seed
-    if( PyTools::extract( "random_seed", random_seed, "Main" ) ) {
-        // Init of the seed for the vectorized C++ random generator recommended by Intel
-        // See https://software.intel.com/en-us/articles/random-number-function-vectorization
-        srand48( random_seed );
-        // Init of the seed for the C++ random generator
-        Rand::gen = std::mt19937( random_seed );
+    // random seed: the one of the master is used by all processes, as the random streams are keyed by patch
+    int seed = 0;
+    if( smpi->isMaster() ) {
+        if( PyTools::extract( "random_seed", random_seed, "Main" ) ) {
+            seed = random_seed;
+        } else {
+            seed = std::random_device()();
+        }
     }
+    smpi->bcast( seed );
+    random_seed = seed;
     
     // communication pattern initialized as partial B exchange
     full_B_exchange = false;
@@ -415,6 +389,13 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
     PyTools::extract( "solve_poisson", solve_poisson, "Main" );
     PyTools::extract( "poisson_max_iteration", poisson_max_iteration, "Main" );
     PyTools::extract( "poisson_max_error", poisson_max_error, "Main" );
+    PyTools::extract( "poisson_solver", poisson_solver, "Main" );
+    if( poisson_solver != "CG" && poisson_solver != "pipelined_CG" ) {
+        ERROR( "poisson_solver must be `CG` or `pipelined_CG`" );
+    }
+    if( poisson_solver == "pipelined_CG" && geometry == "AMcylindrical" ) {
+        ERROR( "poisson_solver = `pipelined_CG` is not available in AMcylindrical geometry" );
+    }
     // Relativistic Poisson Solver
     PyTools::extract( "solve_relativistic_poisson", solve_relativistic_poisson, "Main" );
     PyTools::extract( "relativistic_poisson_max_iteration", relativistic_poisson_max_iteration, "Main" );
@@ -553,6 +534,11 @@ Params::Params( SmileiMPI *smpi, std::vector<std::string> namelistsFiles ) :
         PyTools::extract( "cell_load", cell_load, "LoadBalancing" );
         PyTools::extract( "frozen_particle_load", frozen_particle_load, "LoadBalancing" );
         PyTools::extract( "initial_balance", initial_balance, "LoadBalancing" );
+        PyTools::extract( "cost_model", cost_model, "LoadBalancing" );
+        PyTools::extract( "max_moved_patches", max_moved_patches, "LoadBalancing" );
+        if( cost_model != "particles" && cost_model != "measured" ) {
+            ERROR( "LoadBalancing: `cost_model` must be \"particles\" or \"measured\"" );
+        }
     } else {
         load_balancing_time_selection = new TimeSelection();
     }
@@ -1030,6 +1016,10 @@ void Params::print_init()
         MESSAGE( 1, "Happens: " << load_balancing_time_selection->info() );
         MESSAGE( 1, "Cell load coefficient = " << cell_load );
         MESSAGE( 1, "Frozen particle load coefficient = " << frozen_particle_load );
+        MESSAGE( 1, "Cost model: " << cost_model );
+        if( max_moved_patches > 0 ) {
+            MESSAGE( 1, "At most " << max_moved_patches << " patches moved between two ranks at each balancing" );
+        }
     }
     
     TITLE( "Vectorization: " );
@@ -1108,6 +1098,9 @@ void Params::print_parallelism_params( SmileiMPI *smpi )
 //        nthds = omp_get_num_threads();
 //    }
         MESSAGE( 1, "Number of thread per MPI process : " << smpi->getOMPMaxThreads() );
+#ifdef _OMPTASKS
+        MESSAGE( 1, "Particle dynamics scheduled as OpenMP tasks" );
+#endif
 #else
         MESSAGE( "Disabled" );
 #endif
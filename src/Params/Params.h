@@ -31,25 +31,6 @@ class SmileiMPI;
 class Species;
 class Profile;
 
-namespace Rand
-{
-extern std::random_device device;
-extern std::mt19937 gen;
-
-extern std::uniform_real_distribution<double> uniform_distribution;
-extern double uniform();
-
-extern std::uniform_real_distribution<double> uniform_distribution1;
-extern double uniform1();
-
-extern std::uniform_real_distribution<double> uniform_distribution2;
-extern double uniform2();
-
-extern std::normal_distribution<double> normal_distribution;
-extern double normal( double stddev );
-}
-
-
 // ---------------------------------------------------------------------------------------------------------------------
 //! Params class: holds all the properties of the simulation that are read from the input file
 // ---------------------------------------------------------------------------------------------------------------------
@@ -145,6 +126,8 @@ public:
     unsigned int poisson_max_iteration;
     //! Maxium poisson error tolerated
     double poisson_max_error;
+    //! Poisson solver algorithm: "CG" or "pipelined_CG" (one global reduction per iteration)
+    std::string poisson_solver;
     
     //"Relativistic" Poisson solver
     //! Do we solve "relativistic poisson problem" for relativistic species
@@ -243,6 +226,10 @@ public:
     double cell_load;
     //! Load coefficient applied to a frozen particle (default = 0.1)
     double frozen_particle_load;
+    //! Model for the load of a patch: "particles" (particle counts) or "measured" (timers)
+    std::string cost_model;
+    //! Maximum number of patches moved between two neighbouring ranks at each load balancing (0 = no limit)
+    int max_moved_patches;
     //! Return if number of patch = number of MPI process, to tune IO //ism
     bool one_patch_per_MPI;
     //! Compute an initially balanced patch distribution right from the start
@@ -46,6 +46,9 @@ Patch::Patch( Params &params, SmileiMPI *smpi, DomainDecomposition *domain_decom
     
     initStep1( params );
     
+    measured_load = 0.;
+    measured_steps = 0;
+    
 #ifdef  __DETAILED_TIMERS
     // Initialize timers
     // 0 - Interpolation
@@ -72,6 +75,9 @@ Patch::Patch( Patch *patch, Params &params, SmileiMPI *smpi, DomainDecomposition
     
     initStep1( params );
     
+    measured_load = 0.;
+    measured_steps = 0;
+    
 #ifdef  __DETAILED_TIMERS
     // Initialize timers
     patch_timers.resize( 14, 0. );
@@ -104,14 +110,8 @@ void Patch::initStep1( Params &params )
         oversize[iDim] = params.oversize[iDim];
     }
     
-    // Initialize the state of the random number generator
-    xorshift32_state = params.random_seed;
-    // Ensure that the random seed is different for each patch
-    xorshift32_state += rand();
-    // zero is not acceptable for xorshift
-    if( xorshift32_state==0 ) {
-        xorshift32_state = 1073741824;
-    }
+    // Random number generator: the streams of the patch are keyed by its Hilbert index
+    rand_ = new Random( params.random_seed );
     
     // Obtain the cell_volume
     cell_volume = params.cell_volume;
@@ -376,6 +376,8 @@ Patch::~Patch()
     }
     vecSpecies.clear();
     
+    delete rand_;
+    
 } // END Patch::~Patch
 
 
@@ -525,8 +527,9 @@ void Patch::initExchParticles( SmileiMPI *smpi, int ispec, Params &params )
 // For direction iDim, start exchange of number of particles
 //   - vecPatch : used for intra-MPI process comm (direct copy using Particels::cp_particles)
 //   - smpi     : inhereted from previous SmileiMPI::exchangeParticles()
+//   - mpi_comm, local_comm : treat the MPI neighbours and/or the local neighbours
 // ---------------------------------------------------------------------------------------------------------------------
-void Patch::exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch )
+void Patch::exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch, bool mpi_comm, bool local_comm )
 {
     int h0 = ( *vecPatch )( 0 )->hindex;
     /********************************************************************************/
@@ -537,17 +540,19 @@ void Patch::exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &params, int
             vecSpecies[ispec]->MPIbuff.part_index_send_sz[iDim][iNeighbor] = ( vecSpecies[ispec]->MPIbuff.part_index_send[iDim][iNeighbor] ).size();
             
             if( is_a_MPI_neighbor( iDim, iNeighbor ) ) {
-                //If neighbour is MPI ==> I send him the number of particles I'll send later.
-                int local_hindex = hindex - vecPatch->refHindex_;
-                int tag = buildtag( local_hindex, iDim+1, iNeighbor+3 );
-                MPI_Isend( &( vecSpecies[ispec]->MPIbuff.part_index_send_sz[iDim][iNeighbor] ), 1, MPI_INT, MPI_neighbor_[iDim][iNeighbor], tag, MPI_COMM_WORLD, &( vecSpecies[ispec]->MPIbuff.srequest[iDim][iNeighbor] ) );
-            } else {
+                if( mpi_comm ) {
+                    //If neighbour is MPI ==> I send him the number of particles I'll send later.
+                    int local_hindex = hindex - vecPatch->refHindex_;
+                    int tag = buildtag( local_hindex, iDim+1, iNeighbor+3 );
+                    MPI_Isend( &( vecSpecies[ispec]->MPIbuff.part_index_send_sz[iDim][iNeighbor] ), 1, MPI_INT, MPI_neighbor_[iDim][iNeighbor], tag, MPI_COMM_WORLD, &( vecSpecies[ispec]->MPIbuff.srequest[iDim][iNeighbor] ) );
+                }
+            } else if( local_comm ) {
                 //Else, I directly set the receive size to the correct value.
                 ( *vecPatch )( neighbor_[iDim][iNeighbor]- h0 )->vecSpecies[ispec]->MPIbuff.part_index_recv_sz[iDim][( iNeighbor+1 )%2] = vecSpecies[ispec]->MPIbuff.part_index_send_sz[iDim][iNeighbor];
             }
         } // END of Send
         
-        if( neighbor_[iDim][( iNeighbor+1 )%2]!=MPI_PROC_NULL ) {
+        if( mpi_comm && neighbor_[iDim][( iNeighbor+1 )%2]!=MPI_PROC_NULL ) {
             if( is_a_MPI_neighbor( iDim, ( iNeighbor+1 )%2 ) ) {
                 //If other neighbour is MPI ==> I receive the number of particles I'll receive later.
                 int local_hindex = neighbor_[iDim][( iNeighbor+1 )%2] - smpi->patch_refHindexes[ MPI_neighbor_[iDim][( iNeighbor+1 )%2] ];
@@ -12,6 +12,7 @@
 #include "PartWall.h"
 #include "Interpolator.h"
 #include "Projector.h"
+#include "Random.h"
 
 class DomainDecomposition;
 class Collisions;
@@ -94,19 +95,13 @@ public:
     std::vector<double> patch_timers;
 #endif
     
-    //! Random number generator
-    inline uint32_t xorshift32()
-    {
-        /* Algorithm "xor" from p. 4 of Marsaglia, "Xorshift RNGs" */
-        xorshift32_state ^= xorshift32_state << 13;
-        xorshift32_state ^= xorshift32_state >> 17;
-        xorshift32_state ^= xorshift32_state << 5;
-        return xorshift32_state;
-    }
-    //! State of the random number generator
-    uint32_t xorshift32_state;
-    //! Inverse of the maximum value of the random number generator
-    const double xorshift32_invmax = 1./4294967296.;
+    //! Wall-clock time spent in the particle operators of the patch since the last load balancing
+    double measured_load;
+    //! Number of timesteps accounted for in measured_load
+    unsigned int measured_steps;
+    
+    //! Random number generator, shared by all the stochastic operators of the patch
+    Random *rand_;
     
     // MPI exchange/sum methods for particles/fields
     //   - fields communication specified per geometry (pure virtual)
@@ -116,8 +111,8 @@ public:
     void cleanMPIBuffers( int ispec, Params &params );
     //! manage Idx of particles per direction,
     void initExchParticles( SmileiMPI *smpi, int ispec, Params &params );
-    //! init comm  nbr of particles
-    void exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch );
+    //! init comm  nbr of particles, with MPI neighbours and/or local neighbours
+    void exchNbrOfParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch, bool mpi_comm = true, bool local_comm = true );
     //! finalize comm / nbr of particles, init exch / particles
     void endNbrOfParticles( SmileiMPI *smpi, int ispec, Params &params, int iDim, VectorPatch *vecPatch );
     //! extract particles from main data structure to buffers, init exch / particles
@@ -15,11 +15,15 @@ using namespace std;
 // ---------------------------------------------------------------------------------------------------------------------
 // ---------------------------------------------------------------------------------------------------------------------
 
-void SyncVectorPatch::exchangeParticles( VectorPatch &vecPatches, int ispec, Params &params, SmileiMPI *smpi, Timers &timers, int itime )
+void SyncVectorPatch::exchangeParticles( VectorPatch &vecPatches, int ispec, Params &params, SmileiMPI *smpi, Timers &timers, int itime, bool border_started )
 {
+    // Patches with an MPI neighbour along the first dimension may already have
+    // started their exchange (see startExchangeParticles)
     #pragma omp for schedule(runtime)
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
-        vecPatches( ipatch )->initExchParticles( smpi, ispec, params );
+        if( !( border_started && exchangeStartedEarly( vecPatches, ipatch ) ) ) {
+            vecPatches( ipatch )->initExchParticles( smpi, ispec, params );
+        }
     }
     
     // Init comm in direction 0
@@ -29,11 +33,35 @@ void SyncVectorPatch::exchangeParticles( VectorPatch &vecPatches, int ispec, Par
     #pragma omp single
 #endif
     for( unsigned int ipatch=0 ; ipatch<vecPatches.size() ; ipatch++ ) {
-        vecPatches( ipatch )->exchNbrOfParticles( smpi, ispec, params, 0, &vecPatches );
+        // Only the local neighbours remain for the patches which already started
+        bool mpi_comm = !( border_started && exchangeStartedEarly( vecPatches, ipatch ) );
+        vecPatches( ipatch )->exchNbrOfParticles( smpi, ispec, params, 0, &vecPatches, mpi_comm, true );
     }
 }
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Sort the particles to exchange and send their number to the MPI neighbours along the first dimension,
+// for a patch which has finished its dynamics. The local neighbours are treated in exchangeParticles,
+// once all patches have been initialized.
+// ---------------------------------------------------------------------------------------------------------------------
+void SyncVectorPatch::startExchangeParticles( VectorPatch &vecPatches, unsigned int ipatch, int ispec, Params &params, SmileiMPI *smpi )
+{
+    vecPatches( ipatch )->initExchParticles( smpi, ispec, params );
+    vecPatches( ipatch )->exchNbrOfParticles( smpi, ispec, params, 0, &vecPatches, true, false );
+}
+
+
+bool SyncVectorPatch::exchangeStartedEarly( VectorPatch &vecPatches, unsigned int ipatch )
+{
+#ifndef _NO_MPI_TM
+    return vecPatches( ipatch )->has_an_MPI_neighbor( 0 );
+#else
+    return false;
+#endif
+}
+
+
 void SyncVectorPatch::finalize_and_sort_parts( VectorPatch &vecPatches, int ispec, Params &params, SmileiMPI *smpi, Timers &timers, int itime )
 {
     SyncVectorPatch::finalizeExchangeParticles( vecPatches, ispec, 0, params, smpi, timers, itime );
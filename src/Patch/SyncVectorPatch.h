@@ -15,8 +15,12 @@ class SyncVectorPatch
 {
 public :
 
-    //! Particles synchronization
-    static void exchangeParticles( VectorPatch &vecPatches, int ispec, Params &params, SmileiMPI *smpi, Timers &timers, int itime );
+    //! Particles synchronization, border_started if startExchangeParticles was called on the border patches
+    static void exchangeParticles( VectorPatch &vecPatches, int ispec, Params &params, SmileiMPI *smpi, Timers &timers, int itime, bool border_started = false );
+    //! Start the particles synchronization of a border patch as soon as its dynamics is done
+    static void startExchangeParticles( VectorPatch &vecPatches, unsigned int ipatch, int ispec, Params &params, SmileiMPI *smpi );
+    //! True if the particles synchronization of this patch is started by startExchangeParticles
+    static bool exchangeStartedEarly( VectorPatch &vecPatches, unsigned int ipatch );
     static void finalize_and_sort_parts( VectorPatch &vecPatches, int ispec, Params &params, SmileiMPI *smpi, Timers &timers, int itime );
     static void finalizeExchangeParticles( VectorPatch &vecPatches, int ispec, int iDim, Params &params, SmileiMPI *smpi, Timers &timers, int itime );
     
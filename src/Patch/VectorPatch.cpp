@@ -294,49 +294,133 @@ void VectorPatch::dynamics( Params &params,
     diag_flag = needsRhoJsNow( itime );
     
     timers.particles.restart();
-    ostringstream t;
+#ifdef _OMPTASKS
+    // Task-based scheduling : one task per patch and per species.
+    //   - species of a same patch are chained as they project on the same currents
+    //   - the particle exchange of a species starts on a patch as soon as this patch
+    //     and its local neighbours (along the first dimension) have moved this species,
+    //     so that it overlaps the dynamics of the other patches and species.
+    // The particle exchange is then accounted for in timers.particles.
+    #pragma omp single
+    {
+        unsigned int npatches = this->size();
+        unsigned int nspecies = ( *this )( 0 )->vecSpecies.size();
+        // Dependency tokens
+        std::vector<char> patch_token( npatches ), species_token( npatches*nspecies );
+        char *patch_dep = &patch_token[0];
+        char *species_dep = &species_token[0];
+        std::vector<bool> exchange( nspecies );
+        for( unsigned int ispec=0 ; ispec<nspecies ; ispec++ ) {
+            Species *spec = species( 0, ispec );
+            exchange[ispec] = !spec->ponderomotive_dynamics && spec->isProj( time_dual, simWindow );
+        }
+        
+        for( unsigned int ipatch=0 ; ipatch<npatches ; ipatch++ ) {
+            #pragma omp task firstprivate( ipatch ) depend( out: patch_dep[ipatch] )
+            {
+                ( *this )( ipatch )->EMfields->restartRhoJ();
+                ( *this )( ipatch )->measured_steps++;
+            }
+            
+            for( unsigned int ispec=0 ; ispec<nspecies ; ispec++ ) {
+                Species *spec = species( ipatch, ispec );
+                if( spec->ponderomotive_dynamics ) continue;
+                bool push = spec->isProj( time_dual, simWindow ) || diag_flag;
+                bool exch = exchange[ispec];
+                if( !push && !exch ) continue;
+                #pragma omp task firstprivate( ipatch, ispec, push, exch ) shared( params, RadiationTables, MultiphotonBreitWheelerTables ) depend( inout: patch_dep[ipatch] ) depend( out: species_dep[ipatch*nspecies+ispec] )
+                {
+                    if( push ) {
+                        double timer = MPI_Wtime();
+                        speciesDynamics( ipatch, ispec, params, smpi, RadiationTables, MultiphotonBreitWheelerTables, time_dual, itime );
+                        ( *this )( ipatch )->measured_load += MPI_Wtime() - timer;
+                    }
+                    if( exch ) {
+                        ( *this )( ipatch )->initExchParticles( smpi, ispec, params );
+                    }
+                }
+            }
+        }
+        
+        // Number of particles to exchange along the first dimension:
+        // also sets the receive size of the local neighbours, which have to be initialized
+        for( unsigned int ispec=0 ; ispec<nspecies ; ispec++ ) {
+            if( !exchange[ispec] ) continue;
+#ifndef _NO_MPI_TM
+            for( unsigned int ipatch=0 ; ipatch<npatches ; ipatch++ ) {
+                Patch *patch = ( *this )( ipatch );
+                unsigned int ineighbor[2];
+                for( int iNeighbor=0 ; iNeighbor<2 ; iNeighbor++ ) {
+                    ineighbor[iNeighbor] = ipatch;
+                    if( patch->neighbor_[0][iNeighbor]!=MPI_PROC_NULL && !patch->is_a_MPI_neighbor( 0, iNeighbor ) ) {
+                        ineighbor[iNeighbor] = patch->neighbor_[0][iNeighbor] - refHindex_;
+                    }
+                }
+                #pragma omp task firstprivate( ipatch, ispec ) shared( params ) depend( in: species_dep[ineighbor[0]*nspecies+ispec], species_dep[ipatch*nspecies+ispec], species_dep[ineighbor[1]*nspecies+ispec] )
+                ( *this )( ipatch )->exchNbrOfParticles( smpi, ispec, params, 0, this );
+            }
+#endif
+        }
+        
+        #pragma omp taskwait
+        
+#ifdef _NO_MPI_TM
+        for( unsigned int ispec=0 ; ispec<nspecies ; ispec++ ) {
+            if( !exchange[ispec] ) continue;
+            for( unsigned int ipatch=0 ; ipatch<npatches ; ipatch++ ) {
+                ( *this )( ipatch )->exchNbrOfParticles( smpi, ispec, params, 0, this );
+            }
+        }
+#endif
+    }
+#else
+    // Patches at the border of the MPI domain are moved first: the number of particles
+    // they send to their MPI neighbours is posted as soon as they are done, so that
+    // these messages travel while the interior patches are moved.
+    #pragma omp single
+    {
+        border_first_order_.clear();
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            if( ( *this )( ipatch )->has_an_MPI_neighbor() ) {
+                border_first_order_.push_back( ipatch );
+            }
+        }
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            if( !( *this )( ipatch )->has_an_MPI_neighbor() ) {
+                border_first_order_.push_back( ipatch );
+            }
+        }
+    }
+    
     #pragma omp for schedule(runtime)
-    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+    for( unsigned int iorder=0 ; iorder<this->size() ; iorder++ ) {
+        unsigned int ipatch = border_first_order_[iorder];
         ( *this )( ipatch )->EMfields->restartRhoJ();
         //MESSAGE("restart rhoj");
+        double timer = MPI_Wtime();
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             Species * spec = species( ipatch, ispec );
             if( spec->ponderomotive_dynamics ) continue;
             if( spec->isProj( time_dual, simWindow ) || diag_flag ) {
-                // Dynamics with vectorized operators
-                if( spec->vectorized_operators ) {
-                    spec->dynamics( time_dual, ispec,
-                                    emfields( ipatch ),
-                                    params, diag_flag, partwalls( ipatch ),
-                                    ( *this )( ipatch ), smpi,
-                                    RadiationTables,
-                                    MultiphotonBreitWheelerTables,
-                                    localDiags );
-                }
-                // Dynamics with scalar operators
-                else {
-                    if( params.vectorization_mode == "adaptive" ) {
-                        spec->scalar_dynamics( time_dual, ispec,
-                                emfields( ipatch ),
-                                params, diag_flag, partwalls( ipatch ),
-                                ( *this )( ipatch ), smpi,
-                                RadiationTables,
-                                MultiphotonBreitWheelerTables,
-                                localDiags );
-                    } else {
-                        spec->Species::dynamics( time_dual, ispec,
-                                emfields( ipatch ),
-                                params, diag_flag, partwalls( ipatch ),
-                                ( *this )( ipatch ), smpi,
-                                RadiationTables,
-                                MultiphotonBreitWheelerTables,
-                                localDiags );
-                    }
-                } // end if condition on envelope dynamics
+                speciesDynamics( ipatch, ispec, params, smpi, RadiationTables, MultiphotonBreitWheelerTables, time_dual, itime );
             } // end if condition on species
         } // end loop on species
+        ( *this )( ipatch )->measured_load += MPI_Wtime() - timer;
+        ( *this )( ipatch )->measured_steps++;
         //MESSAGE("species dynamics");
+        
+        if( SyncVectorPatch::exchangeStartedEarly( *this, ipatch ) ) {
+            for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
+                Species * spec = species( 0, ispec );
+                if( !spec->ponderomotive_dynamics && spec->isProj( time_dual, simWindow ) ) {
+                    SyncVectorPatch::startExchangeParticles( ( *this ), ipatch, ispec, params, smpi );
+                }
+            }
+        } else {
+            smpi->progress();
+        }
     } // end loop on patches
+#endif
     
     
     timers.particles.update( params.printNow( itime ) );
@@ -350,20 +434,68 @@ void VectorPatch::dynamics( Params &params,
     timers.multiphoton_Breit_Wheeler_timer.update( *this, params.printNow( itime ) );
 #endif
     
+#ifndef _OMPTASKS
     timers.syncPart.restart();
     for( unsigned int ispec=0 ; ispec<( *this )( 0 )->vecSpecies.size(); ispec++ ) {
         Species * spec = species( 0, ispec );
         if( !spec->ponderomotive_dynamics && spec->isProj( time_dual, simWindow ) ) {
-            SyncVectorPatch::exchangeParticles( ( *this ), ispec, params, smpi, timers, itime ); // Included sort_part
+            SyncVectorPatch::exchangeParticles( ( *this ), ispec, params, smpi, timers, itime, true ); // Included sort_part
         } // end condition on species
     } // end loop on species
     //MESSAGE("exchange particles");
     timers.syncPart.update( params.printNow( itime ) );
+#endif
 #ifdef __DETAILED_TIMERS
     timers.sorting.update( *this, params.printNow( itime ) );
 #endif
 } // END dynamics
 
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Move particles of species ispec in patch ipatch, with the operators selected for this species
+// ---------------------------------------------------------------------------------------------------------------------
+void VectorPatch::speciesDynamics( unsigned int ipatch, unsigned int ispec,
+                                   Params &params,
+                                   SmileiMPI *smpi,
+                                   RadiationTables &RadiationTables,
+                                   MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables,
+                                   double time_dual, int itime )
+{
+    Species *spec = species( ipatch, ispec );
+    // Random numbers drawn by this species during this iteration
+    ( *this )( ipatch )->rand_->stream( ( *this )( ipatch )->Hindex(), itime, Random::dynamics, ispec );
+    // Dynamics with vectorized operators
+    if( spec->vectorized_operators ) {
+        spec->dynamics( time_dual, ispec,
+                        emfields( ipatch ),
+                        params, diag_flag, partwalls( ipatch ),
+                        ( *this )( ipatch ), smpi,
+                        RadiationTables,
+                        MultiphotonBreitWheelerTables,
+                        localDiags );
+    }
+    // Dynamics with scalar operators
+    else {
+        if( params.vectorization_mode == "adaptive" ) {
+            spec->scalar_dynamics( time_dual, ispec,
+                                   emfields( ipatch ),
+                                   params, diag_flag, partwalls( ipatch ),
+                                   ( *this )( ipatch ), smpi,
+                                   RadiationTables,
+                                   MultiphotonBreitWheelerTables,
+                                   localDiags );
+        } else {
+            spec->Species::dynamics( time_dual, ispec,
+                                     emfields( ipatch ),
+                                     params, diag_flag, partwalls( ipatch ),
+                                     ( *this )( ipatch ), smpi,
+                                     RadiationTables,
+                                     MultiphotonBreitWheelerTables,
+                                     localDiags );
+        }
+    }
+} // END speciesDynamics
+
 // ---------------------------------------------------------------------------------------------------------------------
 // For all patches, project charge and current densities with standard scheme for diag purposes at t=0
 // ---------------------------------------------------------------------------------------------------------------------
@@ -866,6 +998,8 @@ void VectorPatch::runAllDiags( Params &params, SmileiMPI *smpi, unsigned int iti
             for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
                 globalDiags[idiag]->run( ( *this )( ipatch ), itime, simWindow );
             }
+            // Threads merge their private data
+            globalDiags[idiag]->mergeThreads();
             // MPI procs gather the data and compute
             #pragma omp single
             smpi->computeGlobalDiags( globalDiags[idiag], itime );
@@ -967,6 +1101,11 @@ void VectorPatch::solvePoisson( Params &params, SmileiMPI *smpi )
     // compute control parameter
     double ctrl = rnew_dot_rnew / ( double )( nx_p2_global );
     
+    // Pipelined variant: exits with the loop below already converged or at iteration_max
+    if( params.poisson_solver == "pipelined_CG" ) {
+        iteration = pipelinedConjugateGradient( smpi, 0., iteration_max, error_max, ( double )( nx_p2_global ), false, ctrl );
+    }
+    
     // ---------------------------------------------------------
     // Starting iterative loop for the conjugate gradient method
     // ---------------------------------------------------------
@@ -1322,6 +1461,11 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
     //double ctrl = rnew_dot_rnew / (double)(nx_p2_global);
     double ctrl = sqrt( rnew_dot_rnew ) / norm2_source_term; // initially is equal to one
     
+    // Pipelined variant: exits with the loop below already converged or at iteration_max
+    if( params.poisson_solver == "pipelined_CG" ) {
+        iteration = pipelinedConjugateGradient( smpi, gamma_mean, iteration_max, error_max, norm2_source_term, true, ctrl );
+    }
+    
     // ---------------------------------------------------------
     // Starting iterative loop for the conjugate gradient method
     // ---------------------------------------------------------
@@ -1625,6 +1769,73 @@ void VectorPatch::solveRelativisticPoisson( Params &params, SmileiMPI *smpi, dou
 } // END solveRelativisticPoisson
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Conjugate gradient of Chronopoulos & Gear: the residual r and w = A*r are updated by recurrence so that
+// the two scalar products r.r and w.r of an iteration are computed together, in a single MPI_Allreduce
+// (the classical loop requires one reduction for p.Ap and another one for r.r).
+// Starts from phi, r and p initialized by initPoisson, gamma_mean>0 selects the relativistic operator.
+// ---------------------------------------------------------------------------------------------------------------------
+unsigned int VectorPatch::pipelinedConjugateGradient( SmileiMPI *smpi, double gamma_mean, unsigned int iteration_max, double error_max,
+        double ctrl_norm, bool sqrt_ctrl, double &ctrl )
+{
+    std::vector<Field *> w_;
+    for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+        w_.push_back( ( *this )( ipatch )->EMfields->w_ );
+    }
+    
+    unsigned int iteration = 0;
+    double alpha( 0. ), r_dot_r_old( 0. );
+    while( true ) {
+        // w = A*r (intra & extra MPI exchange)
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            if( gamma_mean > 0. ) {
+                ( *this )( ipatch )->EMfields->compute_Ar_relativistic_Poisson( ( *this )( ipatch ), gamma_mean );
+            } else {
+                ( *this )( ipatch )->EMfields->compute_Ar( ( *this )( ipatch ) );
+            }
+        }
+        SyncVectorPatch::exchange_along_all_directions_noomp( w_, *this, smpi );
+        SyncVectorPatch::finalize_exchange_along_all_directions_noomp( w_, *this );
+        
+        // r.r and w.r in a single reduction
+        double dot_local[2] = { 0., 0. };
+        double dot[2];
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            dot_local[0] += ( *this )( ipatch )->EMfields->compute_r();
+            dot_local[1] += ( *this )( ipatch )->EMfields->compute_wr();
+        }
+        MPI_Allreduce( dot_local, dot, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        double r_dot_r = dot[0];
+        double w_dot_r = dot[1];
+        
+        // compute control parameter
+        ctrl = sqrt_ctrl ? sqrt( r_dot_r ) / ctrl_norm : r_dot_r / ctrl_norm;
+        if( smpi->isMaster() ) {
+            DEBUG( "iteration " << iteration << " done, exiting with control parameter ctrl = " << ctrl );
+        }
+        if( ctrl <= error_max || iteration >= iteration_max ) {
+            break;
+        }
+        iteration++;
+        
+        // new direction, potential and residual
+        double beta = 0.;
+        if( iteration == 1 ) {
+            alpha = r_dot_r / w_dot_r;
+        } else {
+            beta  = r_dot_r / r_dot_r_old;
+            alpha = r_dot_r / ( w_dot_r - beta * r_dot_r / alpha );
+        }
+        r_dot_r_old = r_dot_r;
+        for( unsigned int ipatch=0 ; ipatch<this->size() ; ipatch++ ) {
+            ( *this )( ipatch )->EMfields->update_pipelined_CG( alpha, beta );
+        }
+    }
+    
+    return iteration;
+} // END pipelinedConjugateGradient
+
+
 
 void VectorPatch::solveRelativisticPoissonAM( Params &params, SmileiMPI *smpi, double time_primal )
 {
@@ -2002,7 +2213,14 @@ void VectorPatch::load_balance( Params &params, double time_dual, SmileiMPI *smp
 {
 
     // Compute new patch distribution
-    smpi->recompute_patch_count( params, *this, time_dual );
+    smpi->recompute_patch_count( params, *this, time_dual, itime );
+    
+    // With the measured cost model, the balancing may have been found not worth it
+    if( params.cost_model == "measured" && smpi->patches_moved == 0 ) {
+        return;
+    }
+    
+    double timer = MPI_Wtime();
     
     // Create empty patches according to this new distribution
     this->createPatches( params, smpi, simWindow );
@@ -2010,6 +2228,13 @@ void VectorPatch::load_balance( Params &params, double time_dual, SmileiMPI *smp
     // Proceed to patch exchange, and delete patch which moved
     this->exchangePatches( smpi, params );
     
+    // Measure the cost of moving one patch, for predicting the cost of the next balancing
+    if( params.cost_model == "measured" ) {
+        double elapsed = MPI_Wtime() - timer, max_elapsed;
+        MPI_Allreduce( &elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+        smpi->migration_cost = max_elapsed / ( double )smpi->patches_moved;
+    }
+    
     // Tell that the patches moved this iteration (needed for probes)
     lastIterationPatchesMoved = itime;
     
@@ -2746,7 +2971,7 @@ void VectorPatch::applyAntennas( double time )
 }
 
 // For each patch, apply the collisions
-void VectorPatch::applyCollisions( Params &params, int itime, Timers &timers )
+void VectorPatch::applyCollisions( Params &params, SmileiMPI *smpi, int itime, Timers &timers )
 {
     timers.collisions.restart();
     
@@ -2759,11 +2984,15 @@ void VectorPatch::applyCollisions( Params &params, int itime, Timers &timers )
     unsigned int ncoll = patches_[0]->vecCollisions.size();
     
     #pragma omp for schedule(runtime)
-    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ )
+    for( unsigned int ipatch=0 ; ipatch<size() ; ipatch++ ) {
+        double timer = MPI_Wtime();
         for( unsigned int icoll=0 ; icoll<ncoll; icoll++ ) {
-            patches_[ipatch]->vecCollisions[icoll]->collide( params, patches_[ipatch], itime, localDiags );
+            patches_[ipatch]->rand_->stream( patches_[ipatch]->Hindex(), itime, Random::collisions, icoll );
+            patches_[ipatch]->vecCollisions[icoll]->collide( params, smpi, patches_[ipatch], itime, localDiags );
         }
-        
+        patches_[ipatch]->measured_load += MPI_Wtime() - timer;
+    }
+    
     #pragma omp single
     for( unsigned int icoll=0 ; icoll<ncoll; icoll++ ) {
         Collisions::debug( params, itime, icoll, *this );
@@ -3098,6 +3327,8 @@ void VectorPatch::ponderomotive_update_position_and_currents( Params &params,
         for( unsigned int ispec=0 ; ispec<( *this )( ipatch )->vecSpecies.size() ; ispec++ ) {
             if( ( *this )( ipatch )->vecSpecies[ispec]->isProj( time_dual, simWindow ) || diag_flag ) {
                 if( species( ipatch, ispec )->ponderomotive_dynamics ) {
+                    // Random numbers drawn by the boundary conditions (these species are not moved by speciesDynamics)
+                    ( *this )( ipatch )->rand_->stream( ( *this )( ipatch )->Hindex(), itime, Random::dynamics, ispec );
                     if( ( *this )( ipatch )->vecSpecies[ispec]->vectorized_operators )
                         species( ipatch, ispec )->ponderomotive_update_position_and_currents( time_dual, ispec,
                                 emfields( ipatch ),
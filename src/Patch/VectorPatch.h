@@ -119,6 +119,14 @@ public :
                    double time_dual,
                    Timers &timers, int itime );
                    
+    //! Move particles of species ispec in patch ipatch (vectorized, adaptive or scalar operators)
+    void speciesDynamics( unsigned int ipatch, unsigned int ispec,
+                          Params &params,
+                          SmileiMPI *smpi,
+                          RadiationTables &RadiationTables,
+                          MultiphotonBreitWheelerTables &MultiphotonBreitWheelerTables,
+                          double time_dual, int itime );
+                          
     void finalize_and_sort_parts( Params &params, SmileiMPI *smpi, SimWindow *simWindow,
                                   double time_dual,
                                   Timers &timers, int itime );
@@ -177,6 +185,11 @@ public :
     void solveRelativisticPoisson( Params &params, SmileiMPI *smpi, double time_primal );
     void solveRelativisticPoissonAM( Params &params, SmileiMPI *smpi, double time_primal );
     
+    //! Pipelined conjugate gradient iterations of solvePoisson and solveRelativisticPoisson (gamma_mean>0),
+    //! ctrl = r.r/ctrl_norm, or sqrt(r.r)/ctrl_norm if sqrt_ctrl. Returns the number of iterations.
+    unsigned int pipelinedConjugateGradient( SmileiMPI *smpi, double gamma_mean, unsigned int iteration_max, double error_max,
+            double ctrl_norm, bool sqrt_ctrl, double &ctrl );
+    
     //! For all patch initialize the externals (lasers, fields, antennas)
     void initExternals( Params &params );
     
@@ -184,7 +197,7 @@ public :
     void applyAntennas( double time );
     
     //! For all patches, apply collisions
-    void applyCollisions( Params &params, int itime, Timers &timer );
+    void applyCollisions( Params &params, SmileiMPI *smpi, int itime, Timers &timer );
     
     //! For all patches, allocate a field if not allocated
     void allocateField( unsigned int ifield, Params &params );
@@ -291,6 +304,9 @@ public :
     //! 1st patch index of patches_ (stored for balancing op)
     int refHindex_;
     
+    //! Patches indices, those with an MPI neighbour first (see dynamics)
+    std::vector<unsigned int> border_first_order_;
+    
     //! Count global (MPI x patches) number of particles per species
     void printNumberOfParticles( SmileiMPI *smpi )
     {
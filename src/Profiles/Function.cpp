@@ -1,6 +1,7 @@
 #include "Function.h"
 #include <complex>
 #include <cmath>
+#include <algorithm>
 
 using namespace std;
 
@@ -93,6 +94,136 @@ PyArrayObject* Function_Python2D::complexValueAt(std::vector<PyArrayObject*> x)
 #endif
 
 
+// Compiled python functions
+// The bytecode is run on a block of points at once: each operation loops over the block
+// so that the compiler can vectorize it, and the loop over operations is amortized.
+#define COMPILED_UNARY( expression ) \
+    for( unsigned int i=0; i<n; i++ ) { double a = s0[i]; s0[i] = ( expression ); } break;
+#define COMPILED_BINARY( expression ) \
+    for( unsigned int i=0; i<n; i++ ) { double a = s1[i], b = s0[i]; s1[i] = ( expression ); } break;
+
+static void runCompiled( const vector<int> &ops, const vector<double> &args, const double *const *variables,
+                         unsigned int n, double *values )
+{
+    double stack[Function_Compiled::max_stack][Function_Compiled::block_size];
+    int top = -1;
+    for( unsigned int iop=0; iop<ops.size(); iop++ ) {
+        double *s0 = top>=0 ? stack[top] : NULL;
+        double *s1 = top>=1 ? stack[top-1] : NULL;
+        switch( ops[iop] ) {
+            case Function_Compiled::op_const: {
+                double *s = stack[++top];
+                double c = args[iop];
+                for( unsigned int i=0; i<n; i++ ) s[i] = c;
+                break;
+            }
+            case Function_Compiled::op_var: {
+                double *s = stack[++top];
+                const double *v = variables[( int ) args[iop]];
+                for( unsigned int i=0; i<n; i++ ) s[i] = v[i];
+                break;
+            }
+            case Function_Compiled::op_where: {
+                double *s2 = stack[top-2];
+                for( unsigned int i=0; i<n; i++ ) s2[i] = s2[i]!=0. ? s1[i] : s0[i];
+                top -= 2;
+                break;
+            }
+            case Function_Compiled::op_add  : COMPILED_BINARY( a + b )
+            case Function_Compiled::op_sub  : COMPILED_BINARY( a - b )
+            case Function_Compiled::op_mul  : COMPILED_BINARY( a * b )
+            case Function_Compiled::op_div  : COMPILED_BINARY( a / b )
+            case Function_Compiled::op_pow  : COMPILED_BINARY( pow( a, b ) )
+            case Function_Compiled::op_mod  : COMPILED_BINARY( a - b*floor( a/b ) )
+            case Function_Compiled::op_atan2: COMPILED_BINARY( atan2( a, b ) )
+            case Function_Compiled::op_min  : COMPILED_BINARY( b < a ? b : a )
+            case Function_Compiled::op_max  : COMPILED_BINARY( b > a ? b : a )
+            case Function_Compiled::op_lt   : COMPILED_BINARY( a <  b ? 1. : 0. )
+            case Function_Compiled::op_le   : COMPILED_BINARY( a <= b ? 1. : 0. )
+            case Function_Compiled::op_gt   : COMPILED_BINARY( a >  b ? 1. : 0. )
+            case Function_Compiled::op_ge   : COMPILED_BINARY( a >= b ? 1. : 0. )
+            case Function_Compiled::op_eq   : COMPILED_BINARY( a == b ? 1. : 0. )
+            case Function_Compiled::op_ne   : COMPILED_BINARY( a != b ? 1. : 0. )
+            case Function_Compiled::op_and  : COMPILED_BINARY( ( a!=0. && b!=0. ) ? 1. : 0. )
+            case Function_Compiled::op_or   : COMPILED_BINARY( ( a!=0. || b!=0. ) ? 1. : 0. )
+            case Function_Compiled::op_neg  : COMPILED_UNARY( -a )
+            case Function_Compiled::op_abs  : COMPILED_UNARY( fabs( a ) )
+            case Function_Compiled::op_floor: COMPILED_UNARY( floor( a ) )
+            case Function_Compiled::op_ceil : COMPILED_UNARY( ceil( a ) )
+            case Function_Compiled::op_exp  : COMPILED_UNARY( exp( a ) )
+            case Function_Compiled::op_log  : COMPILED_UNARY( log( a ) )
+            case Function_Compiled::op_log10: COMPILED_UNARY( log10( a ) )
+            case Function_Compiled::op_sqrt : COMPILED_UNARY( sqrt( a ) )
+            case Function_Compiled::op_sin  : COMPILED_UNARY( sin( a ) )
+            case Function_Compiled::op_cos  : COMPILED_UNARY( cos( a ) )
+            case Function_Compiled::op_tan  : COMPILED_UNARY( tan( a ) )
+            case Function_Compiled::op_asin : COMPILED_UNARY( asin( a ) )
+            case Function_Compiled::op_acos : COMPILED_UNARY( acos( a ) )
+            case Function_Compiled::op_atan : COMPILED_UNARY( atan( a ) )
+            case Function_Compiled::op_sinh : COMPILED_UNARY( sinh( a ) )
+            case Function_Compiled::op_cosh : COMPILED_UNARY( cosh( a ) )
+            case Function_Compiled::op_tanh : COMPILED_UNARY( tanh( a ) )
+        }
+        // Binary operations consume one element of the stack
+        if( ops[iop] >= Function_Compiled::op_add && ops[iop] < Function_Compiled::op_neg ) {
+            top--;
+        }
+    }
+    for( unsigned int i=0; i<n; i++ ) {
+        values[i] = stack[0][i];
+    }
+}
+#undef COMPILED_UNARY
+#undef COMPILED_BINARY
+
+double Function_Compiled::evaluate( const double *x )
+{
+    const double *variables[max_variables];
+    for( unsigned int ivar=0; ivar<nvariables_; ivar++ ) {
+        variables[ivar] = &x[ivar];
+    }
+    double value;
+    runCompiled( ops_, args_, variables, 1, &value );
+    return value;
+}
+double Function_Compiled::valueAt( double time )
+{
+    return evaluate( &time );
+}
+double Function_Compiled::valueAt( vector<double> x_cell, double time )
+{
+    // The time is the last variable, preceded by the first space coordinates
+    double x[4];
+    for( unsigned int ivar=0; ivar+1<nvariables_; ivar++ ) {
+        x[ivar] = x_cell[ivar];
+    }
+    x[nvariables_-1] = time;
+    return evaluate( x );
+}
+double Function_Compiled::valueAt( vector<double> x_cell )
+{
+    return evaluate( &x_cell[0] );
+}
+std::complex<double> Function_Compiled::complexValueAt( vector<double> x_cell, double time )
+{
+    return valueAt( x_cell, time );
+}
+std::complex<double> Function_Compiled::complexValueAt( vector<double> x_cell )
+{
+    return valueAt( x_cell );
+}
+void Function_Compiled::valuesAt( vector<double *> &variables, double *values, unsigned int n )
+{
+    const double *block_variables[max_variables];
+    for( unsigned int first=0; first<n; first+=block_size ) {
+        for( unsigned int ivar=0; ivar<nvariables_; ivar++ ) {
+            block_variables[ivar] = variables[ivar] + first;
+        }
+        runCompiled( ops_, args_, block_variables, min( n-first, ( unsigned int ) block_size ), values + first );
+    }
+}
+
+
 // Constant profiles
 double Function_Constant1D::valueAt( vector<double> x_cell )
 {
@@ -165,6 +165,50 @@ private:
 */
 
 
+// Children class for python functions compiled into a bytecode (see _compile_profile in pyprofiles.py)
+
+class Function_Compiled : public Function
+{
+public:
+    //! Operations of the bytecode, in the same order as _profile_opcodes in pyprofiles.py
+    enum Opcode {
+        op_const, op_var,
+        op_add, op_sub, op_mul, op_div, op_pow, op_mod, op_atan2, op_min, op_max,
+        op_lt, op_le, op_gt, op_ge, op_eq, op_ne, op_and, op_or,
+        op_neg, op_abs, op_floor, op_ceil, op_exp, op_log, op_log10, op_sqrt,
+        op_sin, op_cos, op_tan, op_asin, op_acos, op_atan, op_sinh, op_cosh, op_tanh,
+        op_where
+    };
+    //! Maximum depth of the evaluation stack (same as _profile_max_stack in pyprofiles.py)
+    static const int max_stack = 32;
+    //! Number of points evaluated together in valuesAt
+    static const int block_size = 32;
+    //! Maximum number of variables
+    static const int max_variables = 16;
+
+    Function_Compiled( std::vector<int> ops, std::vector<double> args, unsigned int nvariables ) :
+        ops_( ops ), args_( args ), nvariables_( nvariables ) {};
+    Function_Compiled( Function_Compiled *f ) :
+        ops_( f->ops_ ), args_( f->args_ ), nvariables_( f->nvariables_ ) {};
+    double valueAt( double ); // time
+    double valueAt( std::vector<double>, double ); // space + time
+    double valueAt( std::vector<double> ); // space
+    std::complex<double> complexValueAt( std::vector<double>, double ); // space + time
+    std::complex<double> complexValueAt( std::vector<double> ); // space
+    //! Evaluates the function at n points, each variable being given as an array
+    void valuesAt( std::vector<double *> &variables, double *values, unsigned int n );
+private:
+    //! Evaluates the function at one point
+    double evaluate( const double *variables );
+    //! Operations of the bytecode (postfix notation)
+    std::vector<int> ops_;
+    //! Argument of each operation (value of a constant, or index of a variable)
+    std::vector<double> args_;
+    //! Number of variables of the function
+    unsigned int nvariables_;
+};
+
+
 // Children classes for hard-coded functions
 
 class Function_Constant1D : public Function
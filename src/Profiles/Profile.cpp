@@ -11,7 +11,8 @@ using namespace std;
 Profile::Profile( PyObject *py_profile, unsigned int nvariables, string name, bool try_numpy ) :
     profileName( "" ),
     nvariables_( nvariables ),
-    uses_numpy( false )
+    uses_numpy( false ),
+    compiled( false )
 {
     ostringstream info_( "" );
     info_ << nvariables_ << "D";
@@ -288,19 +289,39 @@ Profile::Profile( PyObject *py_profile, unsigned int nvariables, string name, bo
             }
         }
         
-        // Assign the evaluating function, which depends on the number of arguments
-        if( nvariables_ == 1 ) {
-            function = new Function_Python1D( py_profile );
-        } else if( nvariables_ == 2 ) {
-            function = new Function_Python2D( py_profile );
-        } else if( nvariables_ == 3 ) {
-            function = new Function_Python3D( py_profile );
-        } else if( nvariables_ == 4 ) {
-            function = new Function_Python4D( py_profile );
+        // Try to compile the profile into a bytecode that does not require python
+        PyObject *compiler = PyObject_GetAttrString( PyImport_AddModule( "__main__" ), "_compile_profile" );
+        PyObject *code = PyObject_CallFunction( compiler, const_cast<char *>( "(Oi)" ), py_profile, nvariables_ );
+        PyTools::checkPyError();
+        Py_XDECREF( compiler );
+        if( code && code != Py_None ) {
+            vector<int> ops;
+            vector<double> args;
+            PyTools::convert( PyTuple_GetItem( code, 0 ), ops );
+            PyTools::convert( PyTuple_GetItem( code, 1 ), args );
+            function = new Function_Compiled( ops, args, nvariables_ );
+            compiled = true;
+            uses_numpy = false;
+        }
+        Py_XDECREF( code );
+        
+        // Otherwise, assign the evaluating function, which depends on the number of arguments
+        if( !compiled ) {
+            if( nvariables_ == 1 ) {
+                function = new Function_Python1D( py_profile );
+            } else if( nvariables_ == 2 ) {
+                function = new Function_Python2D( py_profile );
+            } else if( nvariables_ == 3 ) {
+                function = new Function_Python3D( py_profile );
+            } else if( nvariables_ == 4 ) {
+                function = new Function_Python4D( py_profile );
+            }
         }
         
         info_ << " user-defined function";
-        if( try_numpy ) {
+        if( compiled ) {
+            info_ << " (compiled)";
+        } else if( try_numpy ) {
             if( uses_numpy ) {
                 info_ << " (uses numpy)";
             } else {
@@ -320,7 +341,10 @@ Profile::Profile( Profile *p )
     nvariables_ = p->nvariables_;
     info        = p->info       ;
     uses_numpy  = p->uses_numpy ;
-    if( profileName != "" ) {
+    compiled    = p->compiled   ;
+    if( compiled ) {
+        function = new Function_Compiled( static_cast<Function_Compiled *>( p->function ) );
+    } else if( profileName != "" ) {
         if( profileName == "constant" ) {
             if( nvariables_ == 1 ) {
                 function = new Function_Constant1D( static_cast<Function_Constant1D *>( p->function ) );
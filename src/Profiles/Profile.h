@@ -44,6 +44,14 @@ public:
     inline void valuesAt(std::vector<Field*> &coordinates, Field &ret) {
         unsigned int nvar = coordinates.size();
         unsigned int size = coordinates[0]->globalDims_;
+        // If compiled profile, evaluate all points natively
+        if( compiled ) {
+            std::vector<double*> x(nvar);
+            for( unsigned int ivar=0; ivar<nvar; ivar++ )
+                x[ivar] = coordinates[ivar]->data();
+            static_cast<Function_Compiled*>(function)->valuesAt(x, ret.data(), size);
+            return;
+        }
 #ifdef SMILEI_USE_NUMPY
         // If numpy profile, then expose coordinates as numpy before evaluating profile
         if( uses_numpy ) {
@@ -164,6 +172,9 @@ public:
     //! Name of the profile, in the case of a built-in profile
     std::string profileName;
     
+    //! Whether the profile calls a python function (which is not thread-safe)
+    inline bool usesPython() { return profileName.empty() && !compiled; };
+    
 private:
     //! Object that holds the information on the profile function
     Function * function;
@@ -177,6 +188,9 @@ private:
     //! Whether the profile is using numpy
     bool uses_numpy;
     
+    //! Whether the python profile has been compiled (see Function_Compiled)
+    bool compiled;
+    
 };//END class Profile
 
 
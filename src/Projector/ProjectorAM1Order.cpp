@@ -73,7 +73,7 @@ void ProjectorAM1Order::basicForComplex( complex<double> *rhoj, Particles &parti
         }
     }
     
-    complex<double> e_theta = ( particles.position( 1, ipart ) + Icpx*particles.position( 2, ipart ) )/r;
+    complex<double> e_theta = ( ( double )particles.position( 1, ipart ) + Icpx*( double )particles.position( 2, ipart ) )/r;
     complex<double> C_m = 1.;
     if( imode > 0 ) {
         C_m = 2.;
@@ -147,7 +147,7 @@ void ProjectorAM1Order::currents( ElectroMagnAM *emAM, Particles &particles, uns
     double crt_p = charge_weight * ( particles.momentum( 2, ipart )*particles.position( 1, ipart )-particles.momentum( 1, ipart )*particles.position( 2, ipart ) )/( rp )*invgf;
     double crl_p = charge_weight * ( particles.momentum( 0, ipart )) *invgf;
     double crr_p = charge_weight * ( particles.momentum( 1, ipart )*particles.position( 1, ipart ) + particles.momentum( 2, ipart )*particles.position( 2, ipart ))/rp*invgf;
-    e_theta = ( particles.position( 1, ipart ) + Icpx*particles.position( 2, ipart ) )/rp;
+    e_theta = ( ( double )particles.position( 1, ipart ) + Icpx*( double )particles.position( 2, ipart ) )/rp;
     // locate the particle on the primal and dual grid at current time-step & calculate coeff. S1
     xpn = particles.position( 0, ipart ) * dl_inv_;
     int ip = int( xpn );
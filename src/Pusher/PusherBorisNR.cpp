@@ -81,7 +81,7 @@ void PusherBorisNR::operator()( Particles &particles, SmileiMPI *smpi, int istar
     }
     
     if( vecto ) {
-        double *position[3];
+        particle_real *position[3];
         for( int i = 0 ; i<nDim_ ; i++ ) {
             position[i] =  &( particles.position( i, 0 ) );
         }
@@ -35,29 +35,28 @@ void PusherBorisV::operator()( Particles &particles, SmileiMPI *smpi, int istart
     
     //int* cell_keys;
     
-    double *momentum[3];
-    for( int i = 0 ; i<3 ; i++ ) {
-        momentum[i] =  &( particles.momentum( i, 0 ) );
-    }
-    double *position[3];
+    particle_real *const __restrict__ momentum_x = particles.getPtrMomentum( 0 );
+    particle_real *const __restrict__ momentum_y = particles.getPtrMomentum( 1 );
+    particle_real *const __restrict__ momentum_z = particles.getPtrMomentum( 2 );
+    particle_real *position[3];
     for( int i = 0 ; i<nDim_ ; i++ ) {
-        position[i] =  &( particles.position( i, 0 ) );
+        position[i] = particles.getPtrPosition( i );
     }
 #ifdef  __DEBUG
     double *position_old[3];
     for( int i = 0 ; i<nDim_ ; i++ ) {
-        position_old[i] =  &( particles.position_old( i, 0 ) );
+        position_old[i] = particles.getPtrPositionOld( i );
     }
 #endif
-    short *charge = &( particles.charge( 0 ) );
+    const short *const __restrict__ charge = particles.getPtrCharge();
     
     int nparts = Epart->size()/3;
-    double *Ex = &( ( *Epart )[0*nparts] );
-    double *Ey = &( ( *Epart )[1*nparts] );
-    double *Ez = &( ( *Epart )[2*nparts] );
-    double *Bx = &( ( *Bpart )[0*nparts] );
-    double *By = &( ( *Bpart )[1*nparts] );
-    double *Bz = &( ( *Bpart )[2*nparts] );
+    const double *const __restrict__ Ex = &( ( *Epart )[0*nparts] );
+    const double *const __restrict__ Ey = &( ( *Epart )[1*nparts] );
+    const double *const __restrict__ Ez = &( ( *Epart )[2*nparts] );
+    const double *const __restrict__ Bx = &( ( *Bpart )[0*nparts] );
+    const double *const __restrict__ By = &( ( *Bpart )[1*nparts] );
+    const double *const __restrict__ Bz = &( ( *Bpart )[2*nparts] );
     
     //particles.cell_keys.resize(nparts);
     //cell_keys = &( particles.cell_keys[0]);
@@ -79,9 +78,9 @@ void PusherBorisV::operator()( Particles &particles, SmileiMPI *smpi, int istart
         psm[2] = charge_over_mass_dts2*( *( Ez+ipart-ipart_ref ) );
         
         //(*this)(particles, ipart, (*Epart)[ipart], (*Bpart)[ipart] , (*invgf)[ipart]);
-        um[0] = momentum[0][ipart] + psm[0];
-        um[1] = momentum[1][ipart] + psm[1];
-        um[2] = momentum[2][ipart] + psm[2];
+        um[0] = momentum_x[ipart] + psm[0];
+        um[1] = momentum_y[ipart] + psm[1];
+        um[2] = momentum_z[ipart] + psm[2];
         
         // Rotation in the magnetic field
         local_invgf = charge_over_mass_dts2 / sqrt( 1.0 + um[0]*um[0] + um[1]*um[1] + um[2]*um[2] );
@@ -98,9 +97,9 @@ void PusherBorisV::operator()( Particles &particles, SmileiMPI *smpi, int istart
         local_invgf = 1. / sqrt( 1.0 + psm[0]*psm[0] + psm[1]*psm[1] + psm[2]*psm[2] );
         invgf[ipart-ipart_ref] = local_invgf;
         
-        momentum[0][ipart] = psm[0];
-        momentum[1][ipart] = psm[1];
-        momentum[2][ipart] = psm[2];
+        momentum_x[ipart] = psm[0];
+        momentum_y[ipart] = psm[1];
+        momentum_z[ipart] = psm[2];
         
         // Move the particle
 #ifdef  __DEBUG
@@ -35,11 +35,11 @@ void PusherPonderomotivePositionBorisV::operator()( Particles &particles, Smilei
     
     //int* cell_keys;
     
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
-    double *position[3];
+    particle_real *position[3];
     for( int i = 0 ; i<nDim_ ; i++ ) {
         position[i] =  &( particles.position( i, 0 ) );
     }
@@ -148,7 +148,7 @@ void PusherRRLL::operator()( Particles &particles, SmileiMPI *smpi, int istart,
     }
     
     if( vecto ) {
-        double *position[3];
+        particle_real *position[3];
         for( int i = 0 ; i<nDim_ ; i++ ) {
             position[i] =  &( particles.position( i, 0 ) );
         }
@@ -46,11 +46,11 @@ void PusherVay::operator()( Particles &particles, SmileiMPI *smpi, int istart, i
     //double Tx2, Ty2, Tz2;
     //double TxTy, TyTz, TzTx;
     
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
-    double *position[3];
+    particle_real *position[3];
     for( int i = 0 ; i<nDim_ ; i++ ) {
         position[i] =  &( particles.position( i, 0 ) );
     }
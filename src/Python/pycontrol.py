@@ -54,8 +54,17 @@ def _smilei_check():
                 if Checkpoints.file_grouping :
                     my_pattern += "*"+ os.sep
                 my_pattern += "dump-*-*.h5";
-                # pick those file that match the mpi rank
-                my_files = filter(lambda a: smilei_mpi_rank==int(re.search(r'dump-[0-9]*-([0-9]*).h5$',a).groups()[-1]),glob.glob(my_pattern))
+                # pick those file that match the mpi rank: for each dump number, the file
+                # with the largest rank not above smilei_mpi_rank (files shared by several ranks
+                # with Checkpoints.ranks_per_file are numbered after the first rank of the group)
+                def _file_numbers(a):
+                    return [int(n) for n in re.search(r'dump-([0-9]*)-([0-9]*).h5$',a).groups()]
+                my_files = {}
+                for a in glob.glob(my_pattern):
+                    dump_number, file_rank = _file_numbers(a)
+                    if file_rank <= smilei_mpi_rank and file_rank >= _file_numbers(my_files.get(dump_number,a))[1]:
+                        my_files[dump_number] = a
+                my_files = my_files.values()
 
                 if Checkpoints.restart_number:
                     # pick those file that match the restart_number
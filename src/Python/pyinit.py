@@ -195,6 +195,7 @@ class Main(SmileiSingleton):
     solve_poisson = True
     poisson_max_iteration = 50000
     poisson_max_error = 1.e-14
+    poisson_solver = "CG"
 
     # Relativistic Poisson tuning
     solve_relativistic_poisson = False
@@ -292,6 +293,8 @@ class LoadBalancing(SmileiSingleton):
     initial_balance      = True
     cell_load            = 1.0
     frozen_particle_load = 0.1
+    cost_model           = "particles"
+    max_moved_patches    = 0
 
 # Radiation reaction configuration (continuous and MC algorithms)
 class Vectorization(SmileiSingleton):
@@ -319,8 +322,11 @@ class Checkpoints(SmileiSingleton):
     dump_minutes = 0.
     keep_n_dumps = 2
     dump_deflate = 0
+    dump_async = False
     exit_after_dump = True
+    full_dump_every = 1
     file_grouping = None
+    ranks_per_file = None
     restart_files = []
 
 class CurrentFilter(SmileiSingleton):
@@ -447,6 +453,11 @@ class DiagFields(SmileiComponent):
     time_average = 1
     subgrid = None
     flush_every = 1
+    chunks = []
+    deflate = 0
+    shuffle = True
+    datatype = "double"
+    error_bound = 0.
 
 class DiagTrackParticles(SmileiComponent):
     """Track diagnostic"""
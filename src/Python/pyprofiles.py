@@ -727,3 +727,303 @@ except:
         )
         print("WARNING: LaserOffset unavailable because numpy was not found")
 
+
+
+# Compilation of user-defined profiles into a small bytecode evaluated natively
+# (see Function_Compiled). The profile is called once with symbolic arguments,
+# which records the expression it computes. Anything that cannot be recorded
+# (conditions on the arguments, unknown functions, complex numbers, ...) makes
+# the compilation fail, in which case the profile remains a python function.
+
+# The order of this list must match Function_Compiled::Opcode
+_profile_opcodes = ["const", "var",
+    "add", "sub", "mul", "div", "pow", "mod", "atan2", "min", "max",
+    "lt", "le", "gt", "ge", "eq", "ne", "and", "or",
+    "neg", "abs", "floor", "ceil", "exp", "log", "log10", "sqrt",
+    "sin", "cos", "tan", "asin", "acos", "atan", "sinh", "cosh", "tanh",
+    "where"]
+# Must match Function_Compiled::max_stack
+_profile_max_stack = 32
+
+class _ProfileCompileError(Exception):
+    pass
+
+class _ProfileExpr(object):
+    def __init__(self, op, *args):
+        self.op = op
+        self.args = args
+    def __add__(self, o): return _ProfileExpr("add", self, o)
+    def __radd__(self, o): return _ProfileExpr("add", o, self)
+    def __sub__(self, o): return _ProfileExpr("sub", self, o)
+    def __rsub__(self, o): return _ProfileExpr("sub", o, self)
+    def __mul__(self, o): return _ProfileExpr("mul", self, o)
+    def __rmul__(self, o): return _ProfileExpr("mul", o, self)
+    def __truediv__(self, o): return _ProfileExpr("div", self, o)
+    def __rtruediv__(self, o): return _ProfileExpr("div", o, self)
+    __div__ = __truediv__
+    __rdiv__ = __rtruediv__
+    def __floordiv__(self, o): return _ProfileExpr("floor", _ProfileExpr("div", self, o))
+    def __rfloordiv__(self, o): return _ProfileExpr("floor", _ProfileExpr("div", o, self))
+    def __mod__(self, o): return _ProfileExpr("mod", self, o)
+    def __rmod__(self, o): return _ProfileExpr("mod", o, self)
+    def __pow__(self, o): return _ProfileExpr("pow", self, o)
+    def __rpow__(self, o): return _ProfileExpr("pow", o, self)
+    def __neg__(self): return _ProfileExpr("neg", self)
+    def __pos__(self): return self
+    def __abs__(self): return _ProfileExpr("abs", self)
+    def __lt__(self, o): return _ProfileExpr("lt", self, o)
+    def __le__(self, o): return _ProfileExpr("le", self, o)
+    def __gt__(self, o): return _ProfileExpr("gt", self, o)
+    def __ge__(self, o): return _ProfileExpr("ge", self, o)
+    def __eq__(self, o): return _ProfileExpr("eq", self, o)
+    def __ne__(self, o): return _ProfileExpr("ne", self, o)
+    def __and__(self, o): return _ProfileExpr("and", self, o)
+    def __rand__(self, o): return _ProfileExpr("and", o, self)
+    def __or__(self, o): return _ProfileExpr("or", self, o)
+    def __ror__(self, o): return _ProfileExpr("or", o, self)
+    __hash__ = object.__hash__
+    # Python branches on the arguments cannot be recorded
+    def __bool__(self): raise _ProfileCompileError()
+    __nonzero__ = __bool__
+    def __float__(self): raise _ProfileCompileError()
+    def __complex__(self): raise _ProfileCompileError()
+    # numpy functions
+    def __array_ufunc__(self, ufunc, method, *inputs, **kwargs):
+        if method != "__call__" or kwargs or ufunc.__name__ not in _profile_ufuncs:
+            raise _ProfileCompileError()
+        op = _profile_ufuncs[ufunc.__name__]
+        if op == "pos": return inputs[0]
+        if op == "square": return _ProfileExpr("mul", inputs[0], inputs[0])
+        return _ProfileExpr(op, *inputs)
+    def __array_function__(self, func, types, args, kwargs):
+        if func.__name__ == "where" and len(args) == 3 and not kwargs:
+            return _ProfileExpr("where", *args)
+        raise _ProfileCompileError()
+
+_profile_ufuncs = {
+    "add":"add", "subtract":"sub", "multiply":"mul", "true_divide":"div", "divide":"div",
+    "power":"pow", "remainder":"mod", "arctan2":"atan2", "minimum":"min", "maximum":"max",
+    "less":"lt", "less_equal":"le", "greater":"gt", "greater_equal":"ge", "equal":"eq", "not_equal":"ne",
+    "logical_and":"and", "logical_or":"or", "bitwise_and":"and", "bitwise_or":"or",
+    "negative":"neg", "positive":"pos", "absolute":"abs", "fabs":"abs", "square":"square",
+    "floor":"floor", "ceil":"ceil", "exp":"exp", "log":"log", "log10":"log10", "sqrt":"sqrt",
+    "sin":"sin", "cos":"cos", "tan":"tan", "arcsin":"asin", "arccos":"acos", "arctan":"atan",
+    "sinh":"sinh", "cosh":"cosh", "tanh":"tanh",
+}
+
+def _profile_symbolic(function, op):
+    # Wraps a python function so that it records symbolic arguments
+    def f(*args):
+        for a in args:
+            if isinstance(a, _ProfileExpr):
+                return _ProfileExpr(op, *args)
+        return function(*args)
+    return f
+
+def _profile_math_module():
+    import math
+    class _math(object): pass
+    m = _math()
+    for name in dir(math):
+        if not name.startswith("_"):
+            setattr(m, name, getattr(math, name))
+    for name, op in [("fabs","abs"), ("floor","floor"), ("ceil","ceil"), ("exp","exp"),
+                     ("log","log"), ("log10","log10"), ("sqrt","sqrt"), ("sin","sin"),
+                     ("cos","cos"), ("tan","tan"), ("asin","asin"), ("acos","acos"),
+                     ("atan","atan"), ("sinh","sinh"), ("cosh","cosh"), ("tanh","tanh"),
+                     ("atan2","atan2"), ("pow","pow")]:
+        setattr(m, name, _profile_symbolic(getattr(math, name), op))
+    return m
+
+def _profile_rebuild(f, math_module, globals_done, done):
+    # Re-creates the function f so that the math functions and the python functions
+    # it refers to (through its globals or its closure) accept symbolic arguments
+    import math, types
+    def replace(value):
+        if value is math:
+            return math_module
+        if isinstance(value, types.BuiltinFunctionType) and getattr(value, "__module__", None) == "math" \
+            and hasattr(math_module, value.__name__):
+            return getattr(math_module, value.__name__)
+        if isinstance(value, types.FunctionType):
+            return _profile_rebuild(value, math_module, globals_done, done)
+        return value
+    if id(f) in done:
+        return done[id(f)]
+    g = f.__globals__
+    if id(g) not in globals_done:
+        new_globals = dict(g)
+        globals_done[id(g)] = new_globals
+        for name, value in g.items():
+            new_globals[name] = replace(value)
+        for name, function in [("min", min), ("max", max)]:
+            if name not in g:
+                new_globals[name] = _profile_symbolic(function, name)
+    closure = None
+    if f.__closure__:
+        # The closure must be known before re-creating the function, but it may refer to the function itself
+        placeholder = []
+        done[id(f)] = lambda *args: placeholder[0](*args)
+        closure = tuple( (lambda v: lambda: v)(replace(c.cell_contents)).__closure__[0] for c in f.__closure__ )
+        new_f = types.FunctionType(f.__code__, globals_done[id(g)], f.__name__, f.__defaults__, closure)
+        placeholder.append(new_f)
+    else:
+        new_f = types.FunctionType(f.__code__, globals_done[id(g)], f.__name__, f.__defaults__, closure)
+    done[id(f)] = new_f
+    return new_f
+
+def _profile_lower(expr, ops, args):
+    # Writes the expression in postfix notation; returns the required stack depth
+    if isinstance(expr, _ProfileExpr):
+        if expr.op == "var":
+            ops.append(_profile_opcodes.index("var"))
+            args.append(float(expr.args[0]))
+            return 1
+        arity = 3 if expr.op == "where" else 2 if _profile_opcodes.index(expr.op) < _profile_opcodes.index("neg") else 1
+        if len(expr.args) != arity:
+            raise _ProfileCompileError()
+        depth = 0
+        for i, a in enumerate(expr.args):
+            depth = max(depth, i + _profile_lower(a, ops, args))
+        ops.append(_profile_opcodes.index(expr.op))
+        args.append(0.)
+        if len(ops) > 100000:
+            raise _ProfileCompileError()
+        return depth
+    if isinstance(expr, complex) or not hasattr(expr, "__float__"):
+        raise _ProfileCompileError()
+    ops.append(_profile_opcodes.index("const"))
+    args.append(float(expr))
+    return 1
+
+def _profile_run(ops, args, variables):
+    # Python equivalent of Function_Compiled::evaluate, used for validation
+    import math
+    def mod(a, b): return a - b*math.floor(a/b)
+    def safe(f):
+        def g(*a):
+            try: return f(*a)
+            except (ValueError, OverflowError, ZeroDivisionError): return float("nan")
+        return g
+    binary = {
+        "add":lambda a,b:a+b, "sub":lambda a,b:a-b, "mul":lambda a,b:a*b, "div":lambda a,b:a/b,
+        "pow":math.pow, "mod":mod, "atan2":math.atan2, "min":min, "max":max,
+        "lt":lambda a,b:float(a<b), "le":lambda a,b:float(a<=b), "gt":lambda a,b:float(a>b),
+        "ge":lambda a,b:float(a>=b), "eq":lambda a,b:float(a==b), "ne":lambda a,b:float(a!=b),
+        "and":lambda a,b:float(a!=0. and b!=0.), "or":lambda a,b:float(a!=0. or b!=0.),
+    }
+    unary = {
+        "neg":lambda a:-a, "abs":abs, "floor":lambda a:float(math.floor(a)), "ceil":lambda a:float(math.ceil(a)),
+        "exp":math.exp, "log":math.log, "log10":math.log10, "sqrt":math.sqrt, "sin":math.sin, "cos":math.cos,
+        "tan":math.tan, "asin":math.asin, "acos":math.acos, "atan":math.atan, "sinh":math.sinh,
+        "cosh":math.cosh, "tanh":math.tanh,
+    }
+    stack = []
+    for op, arg in zip(ops, args):
+        name = _profile_opcodes[op]
+        if name == "const":
+            stack.append(arg)
+        elif name == "var":
+            stack.append(variables[int(arg)])
+        elif name == "where":
+            c, a, b = stack[-3:]
+            del stack[-3:]
+            stack.append(a if c!=0. else b)
+        elif name in binary:
+            b = stack.pop()
+            stack[-1] = safe(binary[name])(stack[-1], b)
+        else:
+            stack[-1] = safe(unary[name])(stack[-1])
+    return stack[-1]
+
+def _profile_compile(f, nvariables, samples, call):
+    # Traces call(f, variables) with symbolic variables, and compares the resulting
+    # bytecode to the python function at the sample variables
+    import math, types
+    try:
+        if not isinstance(f, types.FunctionType):
+            return None
+        symbolic = _profile_rebuild(f, _profile_math_module(), {}, {})
+        expr = call(symbolic, [_ProfileExpr("var", i) for i in range(nvariables)])
+        ops, args = [], []
+        if _profile_lower(expr, ops, args) > _profile_max_stack:
+            return None
+        nchecked = 0
+        for x in samples:
+            try:
+                expected = call(f, x)
+            except Exception:
+                continue
+            if isinstance(expected, complex):
+                continue
+            expected = float(expected)
+            value = _profile_run(ops, args, x)
+            if math.isnan(expected) and math.isnan(value):
+                pass
+            elif not abs(value - expected) <= 1e-12 * abs(expected) + 1e-300:
+                return None
+            nchecked += 1
+        if nchecked == 0:
+            return None
+        return ops, args
+    except Exception:
+        return None
+
+def _profile_scale():
+    # Typical size of the box and of the simulation time
+    if len(Main)>0:
+        return max([1., Main.simulation_time] + list(Main.grid_length))
+    return 1.
+
+def _compile_profile(f, nvariables):
+    # Returns the bytecode (opcodes, arguments) of the profile f, or None if it cannot be compiled
+    import random
+    # Check points covering the box and the simulation time
+    scale = _profile_scale()
+    rand = random.Random(0)
+    samples = []
+    for i in range(16):
+        length = scale if i%2 else 1.
+        samples.append( [rand.uniform(-0.1*length, 1.1*length) for j in range(nvariables)] )
+    return _profile_compile(f, nvariables, samples, lambda f, x: f(*x))
+
+def _compile_particle_function(f, attributes):
+    # Same as _compile_profile for a function of the particles (track filter, binning axis, ...)
+    # The variables of the bytecode are the particle attributes (space-separated names), followed by Main.iteration
+    import random
+    attributes = attributes.split()
+    class _particles(object): pass
+    def call(f, x):
+        particles = _particles()
+        for attribute, value in zip(attributes, x):
+            setattr(particles, attribute, value)
+        Main.iteration = x[-1]
+        return f(particles)
+    # Check particles spread over the box
+    scale = _profile_scale()
+    rand = random.Random(0)
+    samples = []
+    for i in range(16):
+        x = []
+        for attribute in attributes:
+            if attribute in ["x", "y", "z"]:
+                x.append( rand.uniform(-0.1*scale, 1.1*scale) )
+            elif attribute == "charge":
+                x.append( float(rand.randint(-3, 3)) )
+            elif attribute == "id":
+                x.append( float(rand.randint(0, 1000000)) )
+            elif attribute in ["weight", "chi"]:
+                x.append( rand.uniform(0., 2.) )
+            else:
+                x.append( rand.uniform(-10., 10.) )
+        x.append( float(rand.randint(0, 100000)) )
+        samples.append( x )
+    has_iteration = "iteration" in Main.__dict__
+    iteration = getattr(Main, "iteration", None)
+    try:
+        return _profile_compile(f, len(attributes)+1, samples, call)
+    finally:
+        if has_iteration:
+            Main.iteration = iteration
+        elif "iteration" in Main.__dict__:
+            del Main.iteration
@@ -14,7 +14,7 @@
 //! \param params simulation parameters
 //! \param species Species index
 // -----------------------------------------------------------------------------
-Radiation::Radiation( Params &params, Species *species )
+Radiation::Radiation( Params &params, Species *species, Random *rand )
 {
     // Number of dimensions for the positions and momentums
     n_dimensions_ = params.nDim_particle;
@@ -34,6 +34,8 @@ Radiation::Radiation( Params &params, Species *species )
     
     // The thread radiated energy is initially null
     radiated_energy_ = 0;
+    
+    rand_ = rand;
 }
 
 // -----------------------------------------------------------------------------
@@ -81,7 +83,7 @@ void Radiation::computeParticlesChi( Particles &particles,
     double gamma;
     
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
@@ -90,7 +92,7 @@ void Radiation::computeParticlesChi( Particles &particles,
     short *charge = &( particles.charge( 0 ) );
     
     // Quantum parameter
-    double *chi = &( particles.chi( 0 ) );
+    particle_real *chi = &( particles.chi( 0 ) );
     
     // _______________________________________________________________
     // Computation
@@ -18,6 +18,7 @@
 #include "Particles.h"
 #include "Species.h"
 #include "RadiationTables.h"
+#include "Random.h"
 
 //  ----------------------------------------------------------------------------
 //! Class Radiation
@@ -27,7 +28,7 @@ class Radiation
 
 public:
     //! Creator for Radiation
-    Radiation( Params &params, Species *species );
+    Radiation( Params &params, Species *species, Random *rand );
     virtual ~Radiation();
     
     //! Overloading of () operator
@@ -63,7 +64,7 @@ public:
     //! \param Bz z component of the particle magnetic field
     //#pragma omp declare simd
     double inline computeParticleChi( double &charge_over_mass2,
-                                      double &px, double &py, double &pz,
+                                      double px, double py, double pz,
                                       double &gamma,
                                       double &Ex, double &Ey, double &Ez,
                                       double &Bx, double &By, double &Bz )
@@ -131,6 +132,9 @@ protected:
     //! Inversed Normalized Schwinger Electric field
     double inv_norm_E_Schwinger_;
     
+    //! Random number generator of the patch
+    Random *rand_;
+    
 private:
 
 };//END class
@@ -20,8 +20,8 @@
 //! Constructor for RadiationCorrLandauLifshitz
 //! Inherited from Radiation
 // ---------------------------------------------------------------------------------------------------------------------
-RadiationCorrLandauLifshitz::RadiationCorrLandauLifshitz( Params &params, Species *species )
-    : Radiation( params, species )
+RadiationCorrLandauLifshitz::RadiationCorrLandauLifshitz( Params &params, Species *species, Random *rand )
+    : Radiation( params, species, rand )
 {
 }
 
@@ -85,7 +85,7 @@ void RadiationCorrLandauLifshitz::operator()(
     double temp;
     
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
@@ -94,7 +94,7 @@ void RadiationCorrLandauLifshitz::operator()(
     short *charge = &( particles.charge( 0 ) );
     
     // Weight shortcut
-    double *weight = &( particles.weight( 0 ) );
+    particle_real *weight = &( particles.weight( 0 ) );
     
     // Optical depth for the Monte-Carlo process
     // double* chi = &( particles.chi(0));
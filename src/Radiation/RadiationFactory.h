@@ -32,26 +32,27 @@ public:
     //! Create appropriate radiation model for the species `species`
     //! \param species Species object
     //! \param params Parameters
+    //! \param rand Random number generator of the patch
     //  --------------------------------------------------------------------------------------------------------------------
-    static Radiation *create( Params &params, Species *species )
+    static Radiation *create( Params &params, Species *species, Random *rand )
     {
         Radiation *Radiate = NULL;
         
         // assign the correct Radiation model to Radiate
         if( species->radiation_model == "mc" ) {
-            Radiate = new RadiationMonteCarlo( params, species );
+            Radiate = new RadiationMonteCarlo( params, species, rand );
         }
         // Corrected LL + stochastic diffusive operator
         else if( species->radiation_model == "niel" ) {
-            Radiate = new RadiationNiel( params, species );
+            Radiate = new RadiationNiel( params, species, rand );
         }
         // Corrected continuous radiation loss model
         else if( species->radiation_model == "cll" ) {
-            Radiate = new RadiationCorrLandauLifshitz( params, species );
+            Radiate = new RadiationCorrLandauLifshitz( params, species, rand );
         }
         // Classical continuous radiation loss model from Landau-Lifshitz (LL)
         else if( species->radiation_model == "ll" ) {
-            Radiate = new RadiationLandauLifshitz( params, species );
+            Radiate = new RadiationLandauLifshitz( params, species, rand );
         } else if( species->radiation_model != "none" ) {
             ERROR( "For species " << species->name
                    << ": unknown radiation_model `"
@@ -18,8 +18,8 @@
 //! Inherited from Radiation
 // -----------------------------------------------------------------------------
 RadiationLandauLifshitz::RadiationLandauLifshitz( Params &params,
-        Species *species )
-    : Radiation( params, species )
+        Species *species, Random *rand )
+    : Radiation( params, species, rand )
 {
 }
 
@@ -82,7 +82,7 @@ void RadiationLandauLifshitz::operator()(
     double temp;
     
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
@@ -91,7 +91,7 @@ void RadiationLandauLifshitz::operator()(
     short *charge = &( particles.charge( 0 ) );
     
     // Weight shortcut
-    double *weight = &( particles.weight( 0 ) );
+    particle_real *weight = &( particles.weight( 0 ) );
     
     // Optical depth for the Monte-Carlo process
     // double* chi = &( particles.chi(0));
@@ -20,8 +20,8 @@
 //! Constructor for RadiationMonteCarlo
 //! Inherit from Radiation
 // ---------------------------------------------------------------------------------------------------------------------
-RadiationMonteCarlo::RadiationMonteCarlo( Params &params, Species *species )
-    : Radiation( params, species )
+RadiationMonteCarlo::RadiationMonteCarlo( Params &params, Species *species, Random *rand )
+    : Radiation( params, species, rand )
 {
     this->radiation_photon_sampling_ = species->radiation_photon_sampling_;
     this->radiation_photon_gamma_threshold_ = species->radiation_photon_gamma_threshold_;
@@ -72,22 +72,10 @@ void RadiationMonteCarlo::operator()(
     double *By = &( ( *Bpart )[1*nparts] );
     double *Bz = &( ( *Bpart )[2*nparts] );
     
-    // Charge divided by the square of the mass
-    double charge_over_mass2;
-    
     const double one_over_mass_2 = pow( one_over_mass_, 2. );
     
-    // Temporary quantum parameter
-    double particle_chi;
-    
-    // Temporary Lorentz factor
-    double gamma;
-    
-    // Radiated energy
-    double cont_rad_energy;
-    
-    // Temporary double parameter
-    double temp;
+    // Charge divided by the square of the mass
+    double charge_over_mass2;
     
     // Time to emission
     double emission_time;
@@ -98,14 +86,22 @@ void RadiationMonteCarlo::operator()(
     // Number of Monte-Carlo iteration
     int mc_it_nb;
     
+    // Quantities for a pack of particles
+    double gamma[pack_size_];
+    double particle_chi[pack_size_];
+    // Time of the photon emission during the first Monte-Carlo iteration, -1 if none
+    double first_emission_time[pack_size_];
+    // Indexes in the pack of the particles emitting a photon
+    int emitting[pack_size_];
+    
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, 0 ) );
     }
     
     // Position shortcut
-    double *position[3];
+    particle_real *position[3];
     for( int i = 0 ; i<n_dimensions_ ; i++ ) {
         position[i] =  &( particles.position( i, 0 ) );
     }
@@ -114,136 +110,248 @@ void RadiationMonteCarlo::operator()(
     short *charge = &( particles.charge( 0 ) );
     
     // Weight shortcut
-    double *weight = &( particles.weight( 0 ) );
+    particle_real *weight = &( particles.weight( 0 ) );
     
     // Optical depth for the Monte-Carlo process
-    double *tau = &( particles.tau( 0 ) );
+    particle_real *tau = &( particles.tau( 0 ) );
     
     // Optical depth for the Monte-Carlo process
     // double* chi = &( particles.chi(0));
     
+    const double minimum_chi_discontinuous = RadiationTables.getMinimumChiDiscontinuous();
+    const double minimum_chi_continuous = RadiationTables.getMinimumChiContinuous();
+    
     // Reinitialize the cumulative radiated energy for the current thread
     radiated_energy_ = 0.;
     
     // _______________________________________________________________
     // Computation
     
-    for( int ipart=istart ; ipart<iend; ipart++ ) {
-        charge_over_mass2 = ( double )( charge[ipart] )*one_over_mass_2;
-        
-        // Init local variables
-        emission_time = 0;
-        local_it_time = 0;
-        mc_it_nb = 0;
+    // The first Monte-Carlo iteration is done for packs of particles in vectorized loops.
+    // Only the particles emitting a photon (usually a small subset) are then treated one
+    // by one: photon emission and following Monte-Carlo iterations.
+    for( int ipack=istart ; ipack<iend; ipack+=pack_size_ ) {
+    
+        int npack = iend-ipack < pack_size_ ? iend-ipack : pack_size_;
         
-        // Monte-Carlo Manager inside the time step
-        while( ( local_it_time < dt_ )
-                &&( mc_it_nb < max_monte_carlo_iterations_ ) ) {
-                
-            // Gamma
-            gamma = sqrt( 1.0 + momentum[0][ipart]*momentum[0][ipart]
-                          + momentum[1][ipart]*momentum[1][ipart]
-                          + momentum[2][ipart]*momentum[2][ipart] );
-                          
-            // Computation of the Lorentz invariant quantum parameter
-            particle_chi = Radiation::computeParticleChi( charge_over_mass2,
-                           momentum[0][ipart], momentum[1][ipart], momentum[2][ipart],
-                           gamma,
-                           ( *( Ex+ipart-ipart_ref ) ), ( *( Ey+ipart-ipart_ref ) ), ( *( Ez+ipart-ipart_ref ) ),
-                           ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
-                           
-            // Update the quantum parameter in species
-            // chi[ipart] = particle_chi;
+        // 1. Gamma and quantum parameter (vectorized)
+        #pragma omp simd private( charge_over_mass2 )
+        for( int i=0 ; i<npack; i++ ) {
+            int ipart = ipack+i;
+            
+            charge_over_mass2 = ( double )( charge[ipart] )*one_over_mass_2;
             
-            // Discontinuous emission: New emission
-            // If tau[ipart] <= 0, this is a new emission
-            // We also check that particle_chi > chipa_threshold,
-            // else particle_chi is too low to induce a discontinuous emission
-            if( ( particle_chi > RadiationTables.getMinimumChiDiscontinuous() )
-                    && ( tau[ipart] <= epsilon_tau_ ) ) {
-                // New final optical depth to reach for emision
+            gamma[i] = sqrt( 1.0 + momentum[0][ipart]*momentum[0][ipart]
+                             + momentum[1][ipart]*momentum[1][ipart]
+                             + momentum[2][ipart]*momentum[2][ipart] );
+                             
+            particle_chi[i] = Radiation::computeParticleChi( charge_over_mass2,
+                              momentum[0][ipart], momentum[1][ipart], momentum[2][ipart],
+                              gamma[i],
+                              ( *( Ex+ipart-ipart_ref ) ), ( *( Ey+ipart-ipart_ref ) ), ( *( Ez+ipart-ipart_ref ) ),
+                              ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
+        }
+        
+        // 2. Discontinuous emission: new final optical depth to reach for emission
+        // if tau[ipart] <= 0 and particle_chi is high enough
+        // (the random numbers are drawn in the order of the particles)
+        for( int i=0 ; i<npack; i++ ) {
+            int ipart = ipack+i;
+            if( particle_chi[i] > minimum_chi_discontinuous ) {
                 while( tau[ipart] <= epsilon_tau_ ) {
-                    tau[ipart] = -log( 1.-Rand::uniform() );
+                    tau[ipart] = -log( 1.-rand_->uniform() );
                 }
-                
             }
+        }
+        
+        // 3. Discontinuous emission under progress, or continuous emission (vectorized)
+        double radiated_energy = 0.;
+        #pragma omp simd reduction( +:radiated_energy )
+        for( int i=0 ; i<npack; i++ ) {
+            int ipart = ipack+i;
+            
+            first_emission_time[i] = -1.;
             
-            // Discontinuous emission: emission under progress
-            // If epsilon_tau_ > 0
             if( tau[ipart] > epsilon_tau_ ) {
             
                 // from the cross section
-                temp = RadiationTables.computePhotonProductionYield( particle_chi, gamma );
+                double yield = RadiationTables.computePhotonProductionYield( particle_chi[i], gamma[i] );
                 
                 // Time to discontinuous emission
-                // If this time is > the remaining iteration time,
-                // we have a synchronization
-                emission_time = std::min( tau[ipart]/temp, dt_ - local_it_time );
+                // If this time is > the iteration time, we have a synchronization
+                double time = std::min( tau[ipart]/yield, dt_ );
                 
                 // Update of the optical depth
-                tau[ipart] -= temp*emission_time;
+                tau[ipart] -= yield*time;
                 
-                // If the final optical depth is reached
+                // The final optical depth is reached: emission of a photon
                 if( tau[ipart] <= epsilon_tau_ ) {
-                
-                    // Emission of a photon
-                    RadiationMonteCarlo::photonEmission( ipart,
-                                                         particle_chi, gamma,
-                                                         position,
-                                                         momentum,
-                                                         weight,
-                                                         photon_species,
-                                                         RadiationTables );
-                                                         
-                    // Optical depth becomes negative meaning
-                    // that a new drawing is possible
-                    // at the next Monte-Carlo iteration
-                    tau[ipart] = -1.;
+                    first_emission_time[i] = time;
                 }
                 
-                // Incrementation of the Monte-Carlo iteration counter
-                mc_it_nb ++;
-                // Update of the local time
-                local_it_time += emission_time;
-                
             }
             
-            // Continuous emission
-            // particle_chi needs to be below the discontinuous threshold
-            // particle_chi needs to be above the continuous threshold
-            // No discontunous emission is in progress:
-            // tau[ipart] <= epsilon_tau_
-            else if( ( particle_chi <= RadiationTables.getMinimumChiDiscontinuous() )
-                     && ( tau[ipart] <= epsilon_tau_ )
-                     && ( particle_chi > RadiationTables.getMinimumChiContinuous() )
-                     && ( gamma > 1. ) ) {
+            // Continuous emission: particle_chi is below the discontinuous threshold
+            // (or tau would have been drawn) and above the continuous threshold
+            else if( ( particle_chi[i] > minimum_chi_continuous )
+                     && ( gamma[i] > 1. ) ) {
                      
-                // Remaining time of the iteration
-                emission_time = dt_ - local_it_time;
+                // Radiated energy during the time step
+                double cont_rad_energy = RadiationTables.getRidgersCorrectedRadiatedEnergy( particle_chi[i], dt_ );
                 
-                // Radiated energy during emission_time
-                cont_rad_energy =
-                    RadiationTables.getRidgersCorrectedRadiatedEnergy( particle_chi,
-                            emission_time );
-                            
                 // Effect on the momentum
-                temp = cont_rad_energy*gamma/( gamma*gamma-1. );
-                for( int i = 0 ; i<3 ; i++ ) {
-                    momentum[i][ipart] -= temp*momentum[i][ipart];
-                }
+                double temp = cont_rad_energy*gamma[i]/( gamma[i]*gamma[i]-1. );
+                momentum[0][ipart] -= temp*momentum[0][ipart];
+                momentum[1][ipart] -= temp*momentum[1][ipart];
+                momentum[2][ipart] -= temp*momentum[2][ipart];
                 
                 // Incrementation of the radiated energy cumulative parameter
-                radiated_energy_ += weight[ipart]*( gamma - sqrt( 1.0
-                                                    + momentum[0][ipart]*momentum[0][ipart]
-                                                    + momentum[1][ipart]*momentum[1][ipart]
-                                                    + momentum[2][ipart]*momentum[2][ipart] ) );
-                                                    
-                // End for this particle
-                local_it_time = dt_;
+                radiated_energy += weight[ipart]*( gamma[i] - sqrt( 1.0
+                                                   + momentum[0][ipart]*momentum[0][ipart]
+                                                   + momentum[1][ipart]*momentum[1][ipart]
+                                                   + momentum[2][ipart]*momentum[2][ipart] ) );
+            }
+        }
+        radiated_energy_ += radiated_energy;
+        
+        // 4. Work list of the particles emitting a photon
+        int nemitting = 0;
+        for( int i=0 ; i<npack; i++ ) {
+            if( first_emission_time[i] >= 0. ) {
+                emitting[nemitting++] = i;
             }
-            // No emission since particle_chi is too low
-            else { // if (particle_chi < RadiationTables.getMinimumChiContinuous())
-                local_it_time = dt_;
+        }
+        
+        // 5. Photon emission and following Monte-Carlo iterations inside the time step
+        for( int iemitting=0 ; iemitting<nemitting; iemitting++ ) {
+            int i = emitting[iemitting];
+            int ipart = ipack+i;
+            
+            charge_over_mass2 = ( double )( charge[ipart] )*one_over_mass_2;
+            
+            // Emission of a photon
+            RadiationMonteCarlo::photonEmission( ipart,
+                                                 particle_chi[i], gamma[i],
+                                                 position,
+                                                 momentum,
+                                                 weight,
+                                                 photon_species,
+                                                 RadiationTables );
+                                                 
+            // Optical depth becomes negative meaning
+            // that a new drawing is possible
+            // at the next Monte-Carlo iteration
+            tau[ipart] = -1.;
+            
+            local_it_time = first_emission_time[i];
+            mc_it_nb = 1;
+            
+            // Monte-Carlo Manager inside the time step
+            while( ( local_it_time < dt_ )
+                    &&( mc_it_nb < max_monte_carlo_iterations_ ) ) {
+                    
+                // Gamma
+                gamma[i] = sqrt( 1.0 + momentum[0][ipart]*momentum[0][ipart]
+                                 + momentum[1][ipart]*momentum[1][ipart]
+                                 + momentum[2][ipart]*momentum[2][ipart] );
+                                 
+                // Computation of the Lorentz invariant quantum parameter
+                particle_chi[i] = Radiation::computeParticleChi( charge_over_mass2,
+                                  momentum[0][ipart], momentum[1][ipart], momentum[2][ipart],
+                                  gamma[i],
+                                  ( *( Ex+ipart-ipart_ref ) ), ( *( Ey+ipart-ipart_ref ) ), ( *( Ez+ipart-ipart_ref ) ),
+                                  ( *( Bx+ipart-ipart_ref ) ), ( *( By+ipart-ipart_ref ) ), ( *( Bz+ipart-ipart_ref ) ) );
+                                  
+                // Discontinuous emission: New emission
+                // If tau[ipart] <= 0, this is a new emission
+                // We also check that particle_chi > chipa_threshold,
+                // else particle_chi is too low to induce a discontinuous emission
+                if( ( particle_chi[i] > minimum_chi_discontinuous )
+                        && ( tau[ipart] <= epsilon_tau_ ) ) {
+                    // New final optical depth to reach for emision
+                    while( tau[ipart] <= epsilon_tau_ ) {
+                        tau[ipart] = -log( 1.-rand_->uniform() );
+                    }
+                }
+                
+                // Discontinuous emission: emission under progress
+                // If epsilon_tau_ > 0
+                if( tau[ipart] > epsilon_tau_ ) {
+                
+                    // from the cross section
+                    double yield = RadiationTables.computePhotonProductionYield( particle_chi[i], gamma[i] );
+                    
+                    // Time to discontinuous emission
+                    // If this time is > the remaining iteration time,
+                    // we have a synchronization
+                    emission_time = std::min( tau[ipart]/yield, dt_ - local_it_time );
+                    
+                    // Update of the optical depth
+                    tau[ipart] -= yield*emission_time;
+                    
+                    // If the final optical depth is reached
+                    if( tau[ipart] <= epsilon_tau_ ) {
+                    
+                        // Emission of a photon
+                        RadiationMonteCarlo::photonEmission( ipart,
+                                                             particle_chi[i], gamma[i],
+                                                             position,
+                                                             momentum,
+                                                             weight,
+                                                             photon_species,
+                                                             RadiationTables );
+                                                             
+                        // Optical depth becomes negative meaning
+                        // that a new drawing is possible
+                        // at the next Monte-Carlo iteration
+                        tau[ipart] = -1.;
+                    }
+                    
+                    // Incrementation of the Monte-Carlo iteration counter
+                    mc_it_nb ++;
+                    // Update of the local time
+                    local_it_time += emission_time;
+                    
+                }
+                
+                // Continuous emission
+                // particle_chi needs to be below the discontinuous threshold
+                // particle_chi needs to be above the continuous threshold
+                // No discontunous emission is in progress:
+                // tau[ipart] <= epsilon_tau_
+                else if( ( particle_chi[i] <= minimum_chi_discontinuous )
+                         && ( tau[ipart] <= epsilon_tau_ )
+                         && ( particle_chi[i] > minimum_chi_continuous )
+                         && ( gamma[i] > 1. ) ) {
+                         
+                    // Remaining time of the iteration
+                    emission_time = dt_ - local_it_time;
+                    
+                    // Radiated energy during emission_time
+                    double cont_rad_energy =
+                        RadiationTables.getRidgersCorrectedRadiatedEnergy( particle_chi[i],
+                                emission_time );
+                                
+                    // Effect on the momentum
+                    double temp = cont_rad_energy*gamma[i]/( gamma[i]*gamma[i]-1. );
+                    for( int k = 0 ; k<3 ; k++ ) {
+                        momentum[k][ipart] -= temp*momentum[k][ipart];
+                    }
+                    
+                    // Incrementation of the radiated energy cumulative parameter
+                    radiated_energy_ += weight[ipart]*( gamma[i] - sqrt( 1.0
+                                                        + momentum[0][ipart]*momentum[0][ipart]
+                                                        + momentum[1][ipart]*momentum[1][ipart]
+                                                        + momentum[2][ipart]*momentum[2][ipart] ) );
+                                                        
+                    // End for this particle
+                    local_it_time = dt_;
+                }
+                // No emission since particle_chi is too low
+                else { // if (particle_chi < minimum_chi_continuous)
+                    local_it_time = dt_;
+                }
+                
             }
             
         }
@@ -266,9 +374,9 @@ void RadiationMonteCarlo::operator()(
 void RadiationMonteCarlo::photonEmission( int ipart,
         double &particle_chi,
         double &particle_gamma,
-        double *position[3],
-        double *momentum[3],
-        double *weight,
+        particle_real *position[3],
+        particle_real *momentum[3],
+        particle_real *weight,
         Species *photon_species,
         RadiationTables &RadiationTables )
 {
@@ -280,7 +388,7 @@ void RadiationMonteCarlo::photonEmission( int ipart,
     //double new_norm_p;
     
     // Get the photon quantum parameter from the table xip
-    photon_chi = RadiationTables.computeRandomPhotonChi( particle_chi );
+    photon_chi = RadiationTables.computeRandomPhotonChi( particle_chi, rand_ );
     
     // compute the photon gamma factor
     gammaph = photon_chi/particle_chi*( particle_gamma-1.0 );
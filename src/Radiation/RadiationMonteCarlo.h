@@ -26,7 +26,7 @@ class RadiationMonteCarlo : public Radiation
 public:
 
     //! Constructor for RadiationMonteCarlo
-    RadiationMonteCarlo( Params &params, Species *species );
+    RadiationMonteCarlo( Params &params, Species *species, Random *rand );
     
     //! Destructor for RadiationMonteCarlo
     ~RadiationMonteCarlo();
@@ -67,9 +67,9 @@ public:
     void photonEmission( int ipart,
                          double &particle_chi,
                          double &particle_gamma,
-                         double *position[3],
-                         double *momentum[3],
-                         double *weight,
+                         particle_real *position[3],
+                         particle_real *momentum[3],
+                         particle_real *weight,
                          Species *photon_species,
                          RadiationTables &RadiationTables );
                          
@@ -95,6 +95,9 @@ protected:
     //! Espilon to check when tau is near 0
     const double epsilon_tau_ = 1e-100;
     
+    //! Number of particles treated together in the vectorized loops
+    static const int pack_size_ = 256;
+    
 private:
 
 };
@@ -20,8 +20,8 @@
 //! Constructor for RadiationNLL
 //! Inherited from Radiation
 // -----------------------------------------------------------------------------
-RadiationNiel::RadiationNiel( Params &params, Species *species )
-    : Radiation( params, species )
+RadiationNiel::RadiationNiel( Params &params, Species *species, Random *rand )
+    : Radiation( params, species, rand )
 {
 }
 
@@ -99,7 +99,7 @@ void RadiationNiel::operator()(
     double random_numbers[nbparticles];
     
     // Momentum shortcut
-    double *momentum[3];
+    particle_real *momentum[3];
     for( int i = 0 ; i<3 ; i++ ) {
         momentum[i] =  &( particles.momentum( i, istart ) );
     }
@@ -108,10 +108,10 @@ void RadiationNiel::operator()(
     short *charge = &( particles.charge( istart ) );
     
     // Weight shortcut
-    double *weight = &( particles.weight( istart ) );
+    particle_real *weight = &( particles.weight( istart ) );
     
     // Quantum parameter
-    double *particle_chi = &( particles.chi( istart ) );
+    particle_real *particle_chi = &( particles.chi( istart ) );
     
     // Reinitialize the cumulative radiated energy for the current thread
     radiated_energy_ = 0.;
@@ -156,22 +156,15 @@ void RadiationNiel::operator()(
     
           // Pick a random number in the normal distribution of standard
           // deviation sqrt(dt_) (variance dt_)
-          random_numbers[ipart] = Rand::normal(sqrtdt);
+          random_numbers[ipart] = rand_->normal(sqrtdt);
         }
     }*/
     
     // Vectorized computation of the random number in a uniform distribution
+    rand_->fill( random_numbers, nbparticles );
     #pragma omp simd
     for( ipart=0 ; ipart < nbparticles; ipart++ ) {
-    
-        // Below particle_chi = minimum_chi_continuous_, radiation losses are negligible
-        if( particle_chi[ipart] > minimum_chi_continuous_ ) {
-        
-            // Pick a random number in the normal distribution of standard
-            // deviation sqrt(dt_) (variance dt_)
-            //random_numbers[ipart] = 2.*Rand::uniform() -1.;
-            random_numbers[ipart] = 2.*drand48() -1.;
-        }
+        random_numbers[ipart] = 2.*random_numbers[ipart] -1.;
     }
     
     // Vectorized computation of the random number in a normal distribution
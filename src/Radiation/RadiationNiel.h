@@ -35,7 +35,7 @@ class RadiationNiel : public Radiation
 public:
 
     //! Constructor for RadiationLL
-    RadiationNiel( Params &params, Species *species );
+    RadiationNiel( Params &params, Species *species, Random *rand );
     
     //! Destructor for RadiationLL
     ~RadiationNiel();
@@ -680,6 +680,13 @@ void RadiationTables::compute_xip_table( SmileiMPI *smpi )
 
     }
 
+    // Guide tables for the inversion of xip
+    xip_guide_table.resize( xip_chipa_dim*xip_chiph_dim );
+    for( int ichipa = 0 ; ichipa < xip_chipa_dim ; ichipa++ ) {
+        userFunctions::build_guide_table( &xip_table[ichipa*xip_chiph_dim], xip_chiph_dim,
+                                          &xip_guide_table[ichipa*xip_chiph_dim], xip_chiph_dim );
+    }
+
     t1 = MPI_Wtime();
     MESSAGE( "        done in " << ( t1 - t0 ) << "s" );
 
@@ -1103,8 +1110,9 @@ void RadiationTables::output_tables( SmileiMPI *smpi )
 //! ramdomly and using the tables xip and chiphmin
 //
 //! \param particle_chi particle quantum parameter
+//! \param rand random number generator of the patch
 // -----------------------------------------------------------------------------
-double RadiationTables::computeRandomPhotonChi( double particle_chi )
+double RadiationTables::computeRandomPhotonChi( double particle_chi, Random *rand )
 {
     // Log10 of particle_chi
     double logchipa;
@@ -1140,8 +1148,8 @@ double RadiationTables::computeRandomPhotonChi( double particle_chi )
     // Search of the index ichiph for photon_chi
     // ---------------------------------------
 
-    // First, we compute a random xip in [0,1[
-    xip = Rand::uniform();
+    // First, we compute a random xip in ]0,1[
+    xip = rand->uniform();
 
     // If the randomly computed xip if below the first one of the row,
     // we take the first one which corresponds to the minimal photon photon_chi
@@ -1157,8 +1165,9 @@ double RadiationTables::computeRandomPhotonChi( double particle_chi )
         // If nearest point: ichiph = xip_chiph_dim-1
     } else {
         // Search for the corresponding index ichiph for xip
-        ichiph = userFunctions::search_elem_in_array(
-                     &xip_table[ichipa*xip_chiph_dim], xip, xip_chiph_dim );
+        ichiph = userFunctions::search_elem_in_guided_array(
+                     &xip_table[ichipa*xip_chiph_dim], xip, xip_chiph_dim,
+                     &xip_guide_table[ichipa*xip_chiph_dim], xip_chiph_dim );
     }
 
     // Corresponding particle_chi for ichipa
@@ -1205,52 +1214,6 @@ double RadiationTables::computeRandomPhotonChi( double particle_chi )
     return photon_chi;
 }
 
-// ---------------------------------------------------------------------------------------------------------------------
-//! Computation of the Cross Section dNph/dt which is also
-//! the number of photons generated per time unit.
-//
-//! \param particle_chi particle quantum parameter
-//! \param particle_gamma particle gamma factor
-// ---------------------------------------------------------------------------------------------------------------------
-double RadiationTables::computePhotonProductionYield( double particle_chi, double particle_gamma )
-{
-
-    // Log of the particle quantum parameter particle_chi
-    double logchipa;
-    double logchipam;
-    double logchipap;
-    // Index
-    int ichipa;
-    // final value
-    double dNphdt;
-
-    logchipa = log10( particle_chi );
-
-    // Lower index for interpolation in the table integfochi
-    ichipa = int( floor( ( logchipa-integfochi_log10_chipa_min )
-                         *integfochi_chipa_inv_delta ) );
-
-    // If we are not in the table...
-    if( ichipa < 0 ) {
-        ichipa = 0;
-        dNphdt = integfochi_table[ichipa];
-    } else if( ichipa >= integfochi_dim-1 ) {
-        ichipa = integfochi_dim-2;
-        dNphdt = integfochi_table[ichipa];
-    } else {
-        // Upper and lower values for linear interpolation
-        logchipam = ichipa*integfochi_chipa_delta + integfochi_log10_chipa_min;
-        logchipap = logchipam + integfochi_chipa_delta;
-
-        // Interpolation
-        dNphdt = ( integfochi_table[ichipa+1]*fabs( logchipa-logchipam ) +
-                   integfochi_table[ichipa]*fabs( logchipap - logchipa ) )*integfochi_chipa_inv_delta;
-    }
-
-    return factor_dNphdt*dNphdt*particle_chi/particle_gamma;
-
-}
-
 // ---------------------------------------------------------------------------------------------------------------------
 //! \brief
 //! Compute integration of F/chi between
@@ -1446,7 +1409,8 @@ double RadiationTables::getHNielFromTable( double particle_chi )
 // -----------------------------------------------------------------------------
 double RadiationTables::getNielStochasticTerm( double gamma,
         double particle_chi,
-        double sqrtdt )
+        double sqrtdt,
+        Random *rand )
 {
     // Get the value of h for the corresponding particle_chi
     double h, r;
@@ -1455,7 +1419,7 @@ double RadiationTables::getNielStochasticTerm( double gamma,
 
     // Pick a random number in the normal distribution of standard
     // deviation sqrt(dt) (variance dt)
-    r = Rand::normal( sqrtdt );
+    r = rand->normal( sqrtdt );
 
     /*std::random_device device;
     std::mt19937 gen(device());
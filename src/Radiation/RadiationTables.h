@@ -16,9 +16,11 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <cmath>
 
 #include "Params.h"
 #include "H5.h"
+#include "Random.h"
 
 //------------------------------------------------------------------------------
 //! RadiationTables class: holds parameters, tables and functions to compute
@@ -58,7 +60,36 @@ public:
             
     //! Computation of the photon production yield dNph/dt which is
     //! also the cross-section for the Monte-Carlo
-    double computePhotonProductionYield( double particle_chi, double particle_gamma );
+    //! Inlined, with a direct index in the log-spaced table, so that it can be
+    //! used in vectorized loops
+    //! \param particle_chi particle quantum parameter
+    //! \param particle_gamma particle gamma factor
+    double inline computePhotonProductionYield( double particle_chi, double particle_gamma )
+    {
+        double logchipa = log10( particle_chi );
+        
+        // Lower index for interpolation in the table integfochi
+        int ichipa = int( floor( ( logchipa-integfochi_log10_chipa_min )
+                                 *integfochi_chipa_inv_delta ) );
+                                 
+        double dNphdt;
+        // If we are not in the table...
+        if( ichipa < 0 ) {
+            dNphdt = integfochi_table[0];
+        } else if( ichipa >= integfochi_dim-1 ) {
+            dNphdt = integfochi_table[integfochi_dim-2];
+        } else {
+            // Upper and lower values for linear interpolation
+            double logchipam = ichipa*integfochi_chipa_delta + integfochi_log10_chipa_min;
+            double logchipap = logchipam + integfochi_chipa_delta;
+            
+            // Interpolation
+            dNphdt = ( integfochi_table[ichipa+1]*fabs( logchipa-logchipam ) +
+                       integfochi_table[ichipa]*fabs( logchipap - logchipa ) )*integfochi_chipa_inv_delta;
+        }
+        
+        return factor_dNphdt*dNphdt*particle_chi/particle_gamma;
+    }
     
     //! Compute the integration of the synchrotron emissivity S/chi
     //! refered to as K in the documentation
@@ -77,7 +108,8 @@ public:
     //! from a particle chi value (particle_chi) and
     //! using the tables xip and chiphmin
     //! \param particle_chi particle quantum parameter
-    double computeRandomPhotonChi( double particle_chi );
+    //! \param rand random number generator of the patch
+    double computeRandomPhotonChi( double particle_chi, Random *rand );
     
     //! Return the value of the function h(particle_chi) of Niel et al.
     //! Use an integration of Gauss-Legendre
@@ -97,9 +129,11 @@ public:
     //! \param gamma particle Lorentz factor
     //! \param particle_chi particle quantum parameter
     //! \param dt time step
+    //! \param rand random number generator of the patch
     double getNielStochasticTerm( double gamma,
                                   double particle_chi,
-                                  double dt );
+                                  double dt,
+                                  Random *rand );
                                   
     //! Computation of the corrected continuous quantum radiated energy
     //! during dt from the quantum parameter particle_chi using the Ridgers
@@ -383,6 +417,10 @@ private:
     //! that gives gives the probability for a photon emission in the range \f$[0, \chi_{\gamma}]\f$
     std::vector<double> xip_table;
     
+    //! Guide tables of the rows of xip_table (see userFunctions::build_guide_table),
+    //! to find the interval of a random xip without a bijection
+    std::vector<int> xip_guide_table;
+    
     //! Minimum boundary for particle_chi in the table xip and xip_chiphmin
     double xip_chipa_min;
     
@@ -130,7 +130,7 @@ int main( int argc, char *argv[] )
     // reading from dumped file the restart values
     if( params.restart ) {
         // smpi.patch_count recomputed in readPatchDistribution
-        checkpoint.readPatchDistribution( &smpi, simWindow );
+        checkpoint.readPatchDistribution( &smpi, simWindow, params, vecPatches.domain_decomposition_ );
         // allocate patches according to smpi.patch_count
         PatchesFactory::createVector( vecPatches, params, &smpi, openPMD, checkpoint.this_run_start_step+1, simWindow->getNmoved() );
         // vecPatches data read in restartAll according to smpi.patch_count
@@ -328,7 +328,7 @@ int main( int argc, char *argv[] )
             }
             
             // apply collisions if requested
-            vecPatches.applyCollisions( params, itime, timers );
+            vecPatches.applyCollisions( params, &smpi, itime, timers );
             
             // Solve "Relativistic Poisson" problem (including proper centering of fields)
             // for species who stop to be frozen
@@ -459,6 +459,7 @@ int main( int argc, char *argv[] )
         
     } //End omp parallel region
     
+    checkpoint.waitDump();
     smpi.barrier();
     
     // ------------------------------------------------------------------
@@ -508,7 +509,7 @@ int execute_test_mode( VectorPatch &vecPatches, SmileiMPI *smpi, SimWindow *simW
     int moving_window_movement = 0;
     
     if( params.restart ) {
-        checkpoint.readPatchDistribution( smpi, simWindow );
+        checkpoint.readPatchDistribution( smpi, simWindow, params, vecPatches.domain_decomposition_ );
         itime = checkpoint.this_run_start_step+1;
         moving_window_movement = simWindow->getNmoved();
     }
@@ -118,6 +118,8 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
     patch_count.resize( smilei_sz, 0 );
     capabilities.resize( smilei_sz, 1 );
     Tcapabilities = smilei_sz;
+    patches_moved = 0;
+    migration_cost = 0.;
     
     if( smilei_rk == 0 ) {
         remove( "patch_load.txt" ) ;
@@ -150,6 +152,9 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
         dynamics_PHI_mpart.resize( omp_get_max_threads() );
         dynamics_inv_gamma_ponderomotive.resize( omp_get_max_threads() );
     }
+    
+    collisions_buffer.resize( omp_get_max_threads() );
+    collisions_pairs.resize( omp_get_max_threads() );
 #else
     dynamics_Epart.resize( 1 );
     dynamics_Bpart.resize( 1 );
@@ -167,6 +172,9 @@ void SmileiMPI::init( Params &params, DomainDecomposition *domain_decomposition
         dynamics_PHI_mpart.resize( 1 );
         dynamics_inv_gamma_ponderomotive.resize( 1 );
     }
+    
+    collisions_buffer.resize( 1 );
+    collisions_pairs.resize( 1 );
 #endif
     
     // Set periodicity of the simulated problem
@@ -378,12 +386,12 @@ void SmileiMPI::init_patch_count( Params &params, DomainDecomposition *domain_de
 // ---------------------------------------------------------------------------------------------------------------------
 //  Recompute patch distribution
 // ---------------------------------------------------------------------------------------------------------------------
-void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches, double time_dual )
+void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches, double time_dual, unsigned int itime )
 {
 
     unsigned int ncells_perpatch, j;
     int Ncur;
-    double Tload, Tload_loc, Tcur, cells_load, target, Tscan, largest_patch_loc, largest_patch;
+    double Tload, Tload_loc, Tcur, cells_load, target, Tscan, largest_patch_loc, largest_patch, Tnew_loc;
     bool recompute_tload = true;
     //Load of a cell = cell_load*load of a particle.
     //Load of a frozen particle = frozen_particle_load*load of a particle.
@@ -403,7 +411,50 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     }
     
     unsigned int tot_species_number = vecpatches( 0 )->vecSpecies.size();
-    cells_load = ncells_perpatch*params.cell_load ;
+    
+    // Particle load of each patch, according to the number of particles
+    std::vector<double> Lparticles( patch_count[smilei_rk], 0. );
+    for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+        for( unsigned int ispecies = 0; ispecies < tot_species_number; ispecies++ ) {
+            Lparticles[ipatch] += vecpatches( ipatch )->vecSpecies[ispecies]->getNbrOfParticles()*( 1+( params.frozen_particle_load-1 )*( time_dual < vecpatches( ipatch )->vecSpecies[ispecies]->time_frozen ) ) ;
+        }
+    }
+    
+    // With the measured cost model, loads are in seconds per timestep.
+    // The cost of one particle is fitted over all measured patches, so that the load of a cell
+    // (cell_load) and the load of patches not measured yet are expressed in the same units.
+    double particle_cost = 1.;
+    bool measured = false;
+    if( params.cost_model == "measured" ) {
+        double fit_loc[2] = {0., 0.}, fit[2];
+        for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+            Patch *patch = vecpatches( ipatch );
+            if( patch->measured_steps > 0 ) {
+                fit_loc[0] += patch->measured_load;
+                fit_loc[1] += patch->measured_steps * Lparticles[ipatch];
+            }
+        }
+        MPI_Allreduce( fit_loc, fit, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        if( fit[0] > 0. && fit[1] > 0. ) {
+            particle_cost = fit[0] / fit[1];
+            measured = true;
+            for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+                Patch *patch = vecpatches( ipatch );
+                if( patch->measured_steps > 0 ) {
+                    Lparticles[ipatch] = patch->measured_load / patch->measured_steps;
+                } else {
+                    Lparticles[ipatch] *= particle_cost;
+                }
+            }
+        }
+        // Start a new measurement window
+        for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
+            vecpatches( ipatch )->measured_load = 0.;
+            vecpatches( ipatch )->measured_steps = 0;
+        }
+    }
+    
+    cells_load = ncells_perpatch*params.cell_load*particle_cost ;
     
     Lp.resize( patch_count[smilei_rk] );
     if( smilei_rk > 0 ) {
@@ -425,9 +476,7 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
         
         //Compute particle contribution to Local Loads of each Patch (Lp)
         for( unsigned int ipatch=0; ipatch < ( unsigned int )patch_count[smilei_rk]; ipatch++ ) {
-            for( unsigned int ispecies = 0; ispecies < tot_species_number; ispecies++ ) {
-                Lp[ipatch] += vecpatches( ipatch )->vecSpecies[ispecies]->getNbrOfParticles()*( 1+( params.frozen_particle_load-1 )*( time_dual < vecpatches( ipatch )->vecSpecies[ispecies]->time_frozen ) ) ;
-            }
+            Lp[ipatch] += Lparticles[ipatch];
             Tload_loc += Lp[ipatch];
         }
         
@@ -446,7 +495,7 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
         //If this happens, the code multiplies the cell load coefficient in order to be able to continue.
         if( largest_patch >= Tload ) {
             params.cell_load *= 2.;
-            cells_load = ncells_perpatch*params.cell_load ;
+            cells_load = ncells_perpatch*params.cell_load*particle_cost ;
             WARNING( "Dynamic Load balancing had to increase cell load coefficient because of an overloaded patch with respect to the target load per MPI rank. Try using smaller patches or less MPI ranks." );
         } else {
             recompute_tload = false;
@@ -526,6 +575,11 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
     Ncur += patch_count[smilei_rk] ;
     
     //Ncur now has to be gathered to all as target_patch_count[smilei_rk]
+    std::vector<int> old_patch_count = patch_count;
+    std::vector<int> old_refHindexes( smilei_sz, 0 );
+    for( int rk=1 ; rk<smilei_sz ; rk++ ) {
+        old_refHindexes[rk] = old_refHindexes[rk-1] + old_patch_count[rk-1];
+    }
     MPI_Allgather( &Ncur, 1, MPI_INT, &patch_count[0], 1, MPI_INT, MPI_COMM_WORLD );
     
     patch_refHindexes[0] = 0;
@@ -533,9 +587,65 @@ void SmileiMPI::recompute_patch_count( Params &params, VectorPatch &vecpatches,
         patch_refHindexes[rk] = patch_refHindexes[rk-1] + patch_count[rk-1];
     }
     
+    // Incremental balancing: at most max_moved_patches cross each boundary between two ranks.
+    // The first patches of the ranks stay ordered, so that each rank keeps at least one patch.
+    if( params.max_moved_patches > 0 ) {
+        int total_patches = old_refHindexes[smilei_sz-1] + old_patch_count[smilei_sz-1];
+        for( int rk=1 ; rk<smilei_sz ; rk++ ) {
+            patch_refHindexes[rk] = max( patch_refHindexes[rk], old_refHindexes[rk] - params.max_moved_patches );
+            patch_refHindexes[rk] = min( patch_refHindexes[rk], old_refHindexes[rk] + params.max_moved_patches );
+        }
+        for( int rk=0 ; rk<smilei_sz-1 ; rk++ ) {
+            patch_count[rk] = patch_refHindexes[rk+1] - patch_refHindexes[rk];
+        }
+        patch_count[smilei_sz-1] = total_patches - patch_refHindexes[smilei_sz-1];
+    }
+    
+    // Each shift of the first patch of a rank corresponds to patches moving between two ranks
+    patches_moved = 0;
+    for( int rk=1 ; rk<smilei_sz ; rk++ ) {
+        patches_moved += abs( patch_refHindexes[rk] - old_refHindexes[rk] );
+    }
+    
+    // Tnew_loc = load of this rank after balancing, from the patches gained or lost at both ends
+    Tnew_loc = Tload_loc;
+    int shift_first = patch_refHindexes[smilei_rk] - old_refHindexes[smilei_rk];
+    int shift_last  = patch_refHindexes[smilei_rk] + patch_count[smilei_rk] - old_refHindexes[smilei_rk] - old_patch_count[smilei_rk];
+    for( int i=0; i<-shift_first; i++ ) {
+        Tnew_loc += Lp_left[Lp_left.size()-1-i];
+    }
+    for( int i=0; i<shift_first; i++ ) {
+        Tnew_loc -= Lp[i];
+    }
+    for( int i=0; i<shift_last; i++ ) {
+        Tnew_loc += Lp_right[i];
+    }
+    for( int i=0; i<-shift_last; i++ ) {
+        Tnew_loc -= Lp[old_patch_count[smilei_rk]-1-i];
+    }
+    
+    // With the measured cost model, balance only if the time gained until the next balancing
+    // is larger than the predicted time for moving the patches
+    double gain = 0., cost = 0.;
+    if( measured && patches_moved > 0 ) {
+        double loads_loc[2] = { Tload_loc, Tnew_loc }, loads[2];
+        MPI_Allreduce( loads_loc, loads, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+        int next_time = min( params.load_balancing_time_selection->nextTime( itime+1 ), ( int )params.n_time );
+        gain = ( loads[0] - loads[1] ) * ( double )( next_time - ( int )itime );
+        cost = migration_cost * patches_moved;
+        if( gain <= cost ) {
+            patch_count = old_patch_count;
+            patch_refHindexes = old_refHindexes;
+            patches_moved = 0;
+        }
+    }
+    
     //Write patch_load.txt
     if( smilei_rk==0 ) {
         fout << "\tt = " << time_dual << endl;
+        if( measured ) {
+            fout << " predicted gain = " << gain << " s, predicted cost = " << cost << " s" << endl;
+        }
         for( int irk=0; irk<smilei_sz; irk++ ) {
             fout << " patch_count[" << irk << "] = " << patch_count[irk] << endl;
         }
@@ -599,9 +709,9 @@ MPI_Datatype SmileiMPI::createMPIparticles( Particles *particles )
     }
     
     MPI_Datatype partDataType[nbrOfProp];
-    // define MPI type of each property, default is DOUBLE
+    // define MPI type of each property, default is particle_real
     for( unsigned int i=0 ; i<particles->double_prop.size() ; i++ ) {
-        partDataType[i] = MPI_DOUBLE;
+        partDataType[i] = SMILEI_MPI_PARTICLE_REAL;
     }
     for( unsigned int iprop=0 ; iprop<particles->short_prop.size() ; iprop++ ) {
         partDataType[ particles->double_prop.size()+iprop] = MPI_SHORT;
@@ -1525,7 +1635,7 @@ void SmileiMPI::isend( ProbeParticles *probe, int to, int tag, unsigned int nDim
     // send particles
     if( nPart>0 )
         for( unsigned int i=0; i<nDim_particles; i++ ) {
-            MPI_Isend( &( probe->particles.Position[i][0] ), nPart, MPI_DOUBLE, to, tag+1+i, MPI_COMM_WORLD, &request );
+            MPI_Isend( &( probe->particles.Position[i][0] ), nPart, SMILEI_MPI_PARTICLE_REAL, to, tag+1+i, MPI_COMM_WORLD, &request );
         }
         
 } // End isend ( probes )
@@ -1544,7 +1654,7 @@ void SmileiMPI::recv( ProbeParticles *probe, int from, int tag, unsigned int nDi
     // receive particles
     if( nPart>0 )
         for( unsigned int i=0; i<nDim_particles; i++ ) {
-            MPI_Recv( &( probe->particles.Position[i][0] ), nPart, MPI_DOUBLE, from, tag+1+i, MPI_COMM_WORLD, &status );
+            MPI_Recv( &( probe->particles.Position[i][0] ), nPart, SMILEI_MPI_PARTICLE_REAL, from, tag+1+i, MPI_COMM_WORLD, &status );
         }
         
 } // End recv ( probes )
@@ -1593,85 +1703,35 @@ void SmileiMPI::computeGlobalDiags( Diagnostic *diag, int timestep )
 void SmileiMPI::computeGlobalDiags( DiagnosticScalar *scalars, int timestep )
 {
 
-    if( !scalars->timeSelection->theTimeIsNow( timestep ) ) {
+    if( !scalars->timeSelection->theTimeIsNow( timestep ) || timestep <= scalars->latest_timestep ) {
         return;
     }
     
+    // Only one set of reductions may be pending at a time
+    scalars->finishReduction( true );
+    
+    // The reductions run in the background while the simulation goes on: the master writes them once received
+    scalars->reduction_timestep = timestep;
+    scalars->reduction_requests.resize( scalars->necessary_fieldMinMax_any ? 3 : 1 );
+    
     // Reduce all scalars that should be summed
-    int n_sum = scalars->values_SUM.size();
-    double *d_sum = &scalars->values_SUM[0];
-    MPI_Reduce( isMaster()?MPI_IN_PLACE:d_sum, d_sum, n_sum, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+    scalars->reduced_SUM = scalars->values_SUM;
+    int n_sum = scalars->reduced_SUM.size();
+    double *d_sum = &scalars->reduced_SUM[0];
+    MPI_Ireduce( isMaster()?MPI_IN_PLACE:d_sum, d_sum, n_sum, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD, &scalars->reduction_requests[0] );
     
     if( scalars->necessary_fieldMinMax_any ) {
         // Reduce all scalars that are a "min" and its location
-        int n_min = scalars->values_MINLOC.size();
-        val_index *d_min = &scalars->values_MINLOC[0];
-        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_min, d_min, n_min, MPI_DOUBLE_INT, MPI_MINLOC, 0, MPI_COMM_WORLD );
+        scalars->reduced_MINLOC = scalars->values_MINLOC;
+        int n_min = scalars->reduced_MINLOC.size();
+        val_index *d_min = &scalars->reduced_MINLOC[0];
+        MPI_Ireduce( isMaster()?MPI_IN_PLACE:d_min, d_min, n_min, MPI_DOUBLE_INT, MPI_MINLOC, 0, MPI_COMM_WORLD, &scalars->reduction_requests[1] );
         
         // Reduce all scalars that are a "max" and its location
-        int n_max = scalars->values_MAXLOC.size();
-        val_index *d_max = &scalars->values_MAXLOC[0];
-        MPI_Reduce( isMaster()?MPI_IN_PLACE:d_max, d_max, n_max, MPI_DOUBLE_INT, MPI_MAXLOC, 0, MPI_COMM_WORLD );
-    }
-    
-    // Complete the computation of the scalars after all reductions
-    if( isMaster() ) {
-    
-        // Calculate average Z
-        for( unsigned int ispec=0; ispec<scalars->sDens.size(); ispec++ )
-            if( scalars->sDens[ispec] && scalars->necessary_species[ispec] ) {
-                *scalars->sZavg[ispec] = ( double )*scalars->sZavg[ispec] / ( double )*scalars->sDens[ispec];
-            }
-            
-        // total energy in the simulation
-        if( scalars->necessary_Utot ) {
-            double Ukin = *scalars->Ukin;
-            double Uelm = *scalars->Uelm;
-            double Urad = *scalars->Urad;
-            *scalars->Utot = Ukin + Uelm + Urad;
-        }
-        
-        // expected total energy
-        if( scalars->necessary_Uexp ) {
-            // total energy at time 0
-            if( timestep==0 ) {
-                scalars->Energy_time_zero = *scalars->Utot;
-            }
-            // Global kinetic energy, and BC losses/gains
-            double Ukin_bnd     = *scalars->Ukin_bnd    ;
-            double Ukin_out_mvw = *scalars->Ukin_out_mvw;
-            double Ukin_inj_mvw = *scalars->Ukin_inj_mvw;
-            // Global elm energy, and BC losses/gains
-            double Uelm_bnd     = *scalars->Uelm_bnd    ;
-            double Uelm_out_mvw = *scalars->Uelm_out_mvw;
-            double Uelm_inj_mvw = *scalars->Uelm_inj_mvw;
-            // Global radiated energy
-            double Urad = *scalars->Urad;
-            // expected total energy
-            double Uexp = scalars->Energy_time_zero + Uelm_bnd + Ukin_inj_mvw
-                          + Uelm_inj_mvw
-                          - ( Ukin_bnd + Ukin_out_mvw + Uelm_out_mvw );
-            *scalars->Uexp = Uexp;
-        }
-        
-        if( scalars->necessary_Ubal ) {
-            // energy balance
-            double Ubal = ( double )*scalars->Utot - ( double )*scalars->Uexp;
-            *scalars->Ubal = Ubal;
-            
-            if( scalars->necessary_Ubal_norm ) {
-                // the normalized energy balanced is normalized with respect to the current energy
-                scalars->EnergyUsedForNorm = *scalars->Utot;
-                // normalized energy balance
-                double Ubal_norm( 0. );
-                if( scalars->EnergyUsedForNorm>0. ) {
-                    Ubal_norm = Ubal / scalars->EnergyUsedForNorm;
-                }
-                
-                *scalars->Ubal_norm = Ubal_norm;
-            }
-        }
-        
+        scalars->reduced_MAXLOC = scalars->values_MAXLOC;
+        int n_max = scalars->reduced_MAXLOC.size();
+        val_index *d_max = &scalars->reduced_MAXLOC[0];
+        MPI_Ireduce( isMaster()?MPI_IN_PLACE:d_max, d_max, n_max, MPI_DOUBLE_INT, MPI_MAXLOC, 0, MPI_COMM_WORLD, &scalars->reduction_requests[2] );
     }
 } // END computeGlobalDiags(DiagnosticScalar& scalars ...)
 
@@ -1682,11 +1742,13 @@ void SmileiMPI::computeGlobalDiags( DiagnosticScalar *scalars, int timestep )
 void SmileiMPI::computeGlobalDiags( DiagnosticParticleBinning *diagParticles, int timestep )
 {
     if( timestep - diagParticles->timeSelection->previousTime() == diagParticles->time_average-1 ) {
-        MPI_Reduce( diagParticles->filename.size()?MPI_IN_PLACE:&diagParticles->data_sum[0], &diagParticles->data_sum[0], diagParticles->output_size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
-        
-        if( !isMaster() ) {
-            diagParticles->clear();
-        }
+        // Only one reduction may be pending at a time
+        diagParticles->finishReduction( true );
+        // The data is reduced in the background while the simulation goes on, and written once received
+        diagParticles->data_reduced.swap( diagParticles->data_sum );
+        diagParticles->clear();
+        diagParticles->reduction_timestep = timestep;
+        MPI_Ireduce( diagParticles->filename.size()?MPI_IN_PLACE:&diagParticles->data_reduced[0], &diagParticles->data_reduced[0], diagParticles->output_size, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD, &diagParticles->reduction_request );
     }
 } // END computeGlobalDiags(DiagnosticParticleBinning* diagParticles ...)
 
@@ -24,6 +24,14 @@ class DiagnosticParticleBinning;
 class DiagnosticScreen;
 
 #define SMILEI_COMM_DUMP_TIME 1312
+#define SMILEI_COMM_DUMP_IMAGE 1313
+
+//! MPI datatype of the floating-point particle properties (see particle_real)
+#ifdef SMILEI_SINGLE_PRECISION
+#define SMILEI_MPI_PARTICLE_REAL MPI_FLOAT
+#else
+#define SMILEI_MPI_PARTICLE_REAL MPI_DOUBLE
+#endif
 
 //  --------------------------------------------------------------------------------------------------------------------
 //! Class SmileiMPI
@@ -56,7 +64,7 @@ public:
     virtual void init_patch_count( Params &params, DomainDecomposition *domain_decomposition );
     
     // Recompute the patch_count vector. Browse patches and redistribute them in order to balance the load between MPI processes.
-    void recompute_patch_count( Params &params, VectorPatch &vecpatches, double time_dual );
+    void recompute_patch_count( Params &params, VectorPatch &vecpatches, double time_dual, unsigned int itime );
     // Returns the rank of the MPI process currently owning patch h.
     int hrank( int h );
     
@@ -125,6 +133,12 @@ public:
     {
         MPI_Barrier( SMILEI_COMM_WORLD );
     }
+    //! Let the MPI library progress the pending non-blocking communications
+    inline void progress()
+    {
+        int flag;
+        MPI_Iprobe( MPI_ANY_SOURCE, MPI_ANY_TAG, SMILEI_COMM_WORLD, &flag, MPI_STATUS_IGNORE );
+    }
     //! Return MPI_Comm_rank
     inline int getRank()
     {
@@ -174,6 +188,14 @@ public:
     //! inverse of the ponderomotive gamma, used in susceptibility and ponderomotive momentum Pusher
     std::vector<std::vector<double>> dynamics_inv_gamma_ponderomotive;
     
+    // Global buffers for vectorization of Collisions::collide
+    // -------------------------------------------------------
+    
+    //! particles properties of a block of pairs
+    std::vector<std::vector<double>> collisions_buffer;
+    //! species and particles indices of a block of pairs
+    std::vector<std::vector<unsigned int>> collisions_pairs;
+    
     
     
     // Resize buffers for a given number of particles
@@ -229,6 +251,10 @@ protected:
     //Number of patches owned by each mpi process.
     std::vector<int>  patch_count, capabilities, patch_refHindexes;
     int Tcapabilities; //Default = smilei_sz (1 per MPI rank)
+    //! Number of patches moved by the last call to recompute_patch_count
+    int patches_moved;
+    //! Measured wall-clock time for moving one patch during load balancing (0 until measured)
+    double migration_cost;
 };
 
 
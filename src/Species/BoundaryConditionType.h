@@ -146,14 +146,14 @@ inline int thermalize_particle( Particles &particles, int ipart, int direction,
                 // change of velocity in the direction normal to the reflection plane
                 double sign_vel = -particles.momentum( i, ipart )/std::abs( particles.momentum( i, ipart ) );
                 particles.momentum( i, ipart ) = sign_vel * species->thermalMomentum[i]
-                                                 *                             std::sqrt( -std::log( 1.0-Rand::uniform1() ) );
+                                                 *                             std::sqrt( -std::log( species->rand_->uniform() ) );
                                                  
             } else {
                 // change of momentum in the direction(s) along the reflection plane
-                double sign_rnd = Rand::uniform() - 0.5;
+                double sign_rnd = species->rand_->uniform() - 0.5;
                 sign_rnd = ( sign_rnd )/std::abs( sign_rnd );
                 particles.momentum( i, ipart ) = sign_rnd * species->thermalMomentum[i]
-                                                 *                             userFunctions::erfinv( Rand::uniform1() );
+                                                 *                             userFunctions::erfinv( species->rand_->uniform() );
             }//if
             
         }//i
@@ -208,7 +208,7 @@ inline int thermalize_particle( Particles &particles, int ipart, int direction,
     if ( ( particles.position(1,ipart) >= val_min ) && ( particles.position(1,ipart) <= val_max ) ) {
         // nrj computed during diagnostics
         particles.position(direction, ipart) = limit_pos - particles.position(direction, ipart);
-        particles.momentum(direction, ipart) = sqrt(params.thermalVelocity[direction]) * tabFcts.erfinv( Rand::uniform() );
+        particles.momentum(direction, ipart) = sqrt(params.thermalVelocity[direction]) * tabFcts.erfinv( species->rand_->uniform() );
     }
     else {
         stop_particle( particles, ipart, direction, limit_pos, params, nrj_iPart );
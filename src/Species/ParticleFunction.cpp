@@ -0,0 +1,130 @@
+#include "ParticleFunction.h"
+
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+ParticleFunction::ParticleFunction( Function_Compiled *function, vector<int> attributes ) :
+    function_( function ),
+    attributes_( attributes )
+{
+}
+
+ParticleFunction::~ParticleFunction()
+{
+    delete function_;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Compile the python function, with the particle attributes available in this simulation
+// ---------------------------------------------------------------------------------------------------------------------
+ParticleFunction *ParticleFunction::create( PyObject *function, vector<Particles *> particles, bool has_iteration )
+{
+    const char *names[number_of_attributes] = { "x", "y", "z", "px", "py", "pz", "weight", "charge", "chi", "id", "iteration" };
+    // The quantum parameter and the IDs are not always stored
+    bool has_chi = true, has_id = true;
+    for( unsigned int i=0; i<particles.size(); i++ ) {
+        has_chi = has_chi && particles[i]->isQuantumParameter;
+        has_id  = has_id  && particles[i]->tracked;
+    }
+    vector<int> attributes;
+    for( unsigned int i=0; i<particles[0]->Position.size(); i++ ) {
+        attributes.push_back( attr_x + i );
+    }
+    for( int i=attr_px; i<=attr_id; i++ ) {
+        if( ( i != attr_chi || has_chi ) && ( i != attr_id || has_id ) ) {
+            attributes.push_back( i );
+        }
+    }
+    // The attribute names are given to python as a space-separated string
+    ostringstream list( "" );
+    for( unsigned int i=0; i<attributes.size(); i++ ) {
+        list << names[attributes[i]] << " ";
+    }
+    // Main.iteration is the last variable
+    attributes.push_back( attr_iteration );
+    
+    PyObject *compiler = PyObject_GetAttrString( PyImport_AddModule( "__main__" ), "_compile_particle_function" );
+    PyObject *code = PyObject_CallFunction( compiler, const_cast<char *>( "(Os)" ), function, list.str().c_str() );
+    PyTools::checkPyError();
+    Py_XDECREF( compiler );
+    if( !code || code == Py_None ) {
+        Py_XDECREF( code );
+        return NULL;
+    }
+    vector<int> ops;
+    vector<double> args;
+    PyTools::convert( PyTuple_GetItem( code, 0 ), ops );
+    PyTools::convert( PyTuple_GetItem( code, 1 ), args );
+    Py_DECREF( code );
+    
+    // Refuse functions of Main.iteration when the iteration is not known
+    if( ! has_iteration ) {
+        for( unsigned int iop=0; iop<ops.size(); iop++ ) {
+            if( ops[iop] == Function_Compiled::op_var && ( unsigned int ) args[iop] == attributes.size()-1 ) {
+                return NULL;
+            }
+        }
+    }
+    
+    return new ParticleFunction( new Function_Compiled( ops, args, attributes.size() ), attributes );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Evaluate the function by blocks of particles: the attributes of each block are copied in double precision
+// ---------------------------------------------------------------------------------------------------------------------
+void ParticleFunction::valuesAt( Particles *particles, unsigned int npart, int itime, double *values )
+{
+    const unsigned int block_size = Function_Compiled::block_size;
+    unsigned int nvariables = attributes_.size();
+    double buffer[number_of_attributes][block_size];
+    vector<double *> variables( nvariables );
+    for( unsigned int ivar=0; ivar<nvariables; ivar++ ) {
+        variables[ivar] = buffer[ivar];
+    }
+    
+    for( unsigned int first=0; first<npart; first+=block_size ) {
+        unsigned int n = min( npart-first, block_size );
+        for( unsigned int ivar=0; ivar<nvariables; ivar++ ) {
+            double *b = buffer[ivar];
+            int attribute = attributes_[ivar];
+            if( attribute <= attr_z ) {
+                particle_real *x = &particles->Position[attribute - attr_x][first];
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = x[i];
+                }
+            } else if( attribute <= attr_pz ) {
+                particle_real *p = &particles->Momentum[attribute - attr_px][first];
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = p[i];
+                }
+            } else if( attribute == attr_weight ) {
+                particle_real *w = &particles->Weight[first];
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = w[i];
+                }
+            } else if( attribute == attr_charge ) {
+                short *q = &particles->Charge[first];
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = q[i];
+                }
+            } else if( attribute == attr_chi ) {
+                particle_real *chi = &particles->Chi[first];
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = chi[i];
+                }
+            } else if( attribute == attr_id ) {
+                uint64_t *id = &particles->Id[first];
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = ( double ) id[i];
+                }
+            } else {
+                for( unsigned int i=0; i<n; i++ ) {
+                    b[i] = itime;
+                }
+            }
+        }
+        function_->valuesAt( variables, values + first, n );
+    }
+}
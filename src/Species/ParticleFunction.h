@@ -0,0 +1,41 @@
+#ifndef PARTICLEFUNCTION_H
+#define PARTICLEFUNCTION_H
+
+#include "PyTools.h"
+#include "Function.h"
+#include "Particles.h"
+
+#include <vector>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class ParticleFunction
+//! User-defined python function of the particles (track filter, histogram axis, ...) compiled into
+//! a bytecode (see _compile_particle_function in pyprofiles.py), so that it is evaluated without python
+//  --------------------------------------------------------------------------------------------------------------------
+class ParticleFunction
+{
+public:
+    //! Compiles the python function, or returns NULL if it cannot be compiled
+    //! The function may use the attributes available in all the given particles,
+    //! and Main.iteration if has_iteration is true
+    static ParticleFunction *create( PyObject *function, std::vector<Particles *> particles, bool has_iteration );
+    //! ParticleFunction destructor
+    ~ParticleFunction();
+    
+    //! Evaluates the function for the first npart particles, at the iteration itime
+    void valuesAt( Particles *particles, unsigned int npart, int itime, double *values );
+    
+private:
+    ParticleFunction( Function_Compiled *function, std::vector<int> attributes );
+    
+    //! Particle attributes which may be used in a function
+    enum Attribute { attr_x, attr_y, attr_z, attr_px, attr_py, attr_pz, attr_weight, attr_charge, attr_chi, attr_id, attr_iteration, number_of_attributes };
+    
+    //! Compiled function
+    Function_Compiled *function_;
+    
+    //! Attribute corresponding to each variable of the function
+    std::vector<int> attributes_;
+};
+
+#endif
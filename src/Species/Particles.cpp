@@ -115,33 +115,32 @@ void Particles::initialize( unsigned int nParticles, Particles &part )
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::reserve( unsigned int n_part_max, unsigned int nDim )
 {
-    return;
-    
-    Position.resize( nDim );
-    Position_old.resize( nDim );
-    for( unsigned int i=0 ; i< nDim ; i++ ) {
-        Position[i].reserve( n_part_max );
-        Position_old[i].reserve( n_part_max );
-    }
-    Momentum.resize( 3 );
-    for( unsigned int i=0 ; i< 3 ; i++ ) {
-        Momentum[i].reserve( n_part_max );
+    for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
+        double_prop[iprop]->reserve( n_part_max );
     }
-    Weight.reserve( n_part_max );
-    Charge.reserve( n_part_max );
     
-    if( tracked ) {
-        Id.reserve( n_part_max );
+    for( unsigned int iprop=0 ; iprop<short_prop.size() ; iprop++ ) {
+        short_prop[iprop]->reserve( n_part_max );
     }
     
-    if( isQuantumParameter ) {
-        Chi.reserve( n_part_max );
+    for( unsigned int iprop=0 ; iprop<uint64_prop.size() ; iprop++ ) {
+        uint64_prop[iprop]->reserve( n_part_max );
     }
     
-    if( isMonteCarlo ) {
-        Tau.reserve( n_part_max );
+    cell_keys.reserve( n_part_max );
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Grow the capacity of all Particles vectors at once, following a single geometric policy
+// so that a sequence of insertions only triggers a logarithmic number of reallocations
+// ---------------------------------------------------------------------------------------------------------------------
+void Particles::grow( unsigned int n_part )
+{
+    unsigned int n_part_max = ( unsigned int )( growth_factor * capacity() );
+    if( n_part_max < n_part ) {
+        n_part_max = n_part;
     }
-    
+    reserve( n_part_max, dimension() );
 }
 
 void Particles::resize( unsigned int nParticles, unsigned int nDim )
@@ -183,15 +182,15 @@ void Particles::shrink_to_fit( unsigned int nDim )
 {
 
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
-        std::vector<double>( *double_prop[iprop] ).swap( *double_prop[iprop] );
+        aligned_vector<particle_real>( *double_prop[iprop] ).swap( *double_prop[iprop] );
     }
     
     for( unsigned int iprop=0 ; iprop<short_prop.size() ; iprop++ ) {
-        std::vector<short>( *short_prop[iprop] ).swap( *short_prop[iprop] );
+        aligned_vector<short>( *short_prop[iprop] ).swap( *short_prop[iprop] );
     }
     
     for( unsigned int iprop=0 ; iprop<uint64_prop.size() ; iprop++ ) {
-        std::vector<uint64_t>( *uint64_prop[iprop] ).swap( *uint64_prop[iprop] );
+        aligned_vector<uint64_t>( *uint64_prop[iprop] ).swap( *uint64_prop[iprop] );
     }
 }
 
@@ -217,6 +216,8 @@ void Particles::clear()
 
 void Particles::cp_particle( unsigned int ipart )
 {
+    ensure_capacity( size()+1 );
+    
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
         double_prop[iprop]->push_back( ( *double_prop[iprop] )[ipart] );
     }
@@ -236,6 +237,8 @@ void Particles::cp_particle( unsigned int ipart )
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::cp_particle( unsigned int ipart, Particles &dest_parts )
 {
+    dest_parts.ensure_capacity( dest_parts.size()+1 );
+    
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
         dest_parts.double_prop[iprop]->push_back( ( *double_prop[iprop] )[ipart] );
     }
@@ -254,6 +257,8 @@ void Particles::cp_particle( unsigned int ipart, Particles &dest_parts )
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::cp_particle( unsigned int ipart, Particles &dest_parts, int dest_id )
 {
+    dest_parts.ensure_capacity( dest_parts.size()+1 );
+    
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
         dest_parts.double_prop[iprop]->insert( dest_parts.double_prop[iprop]->begin() + dest_id, ( *double_prop[iprop] )[ipart] );
     }
@@ -273,6 +278,8 @@ void Particles::cp_particle( unsigned int ipart, Particles &dest_parts, int dest
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::cp_particles( unsigned int iPart, unsigned int nPart, Particles &dest_parts, int dest_id )
 {
+    dest_parts.ensure_capacity( dest_parts.size()+nPart );
+    
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
         dest_parts.double_prop[iprop]->insert( dest_parts.double_prop[iprop]->begin() + dest_id, double_prop[iprop]->begin()+iPart, double_prop[iprop]->begin()+iPart+nPart );
     }
@@ -292,6 +299,8 @@ void Particles::cp_particles( unsigned int iPart, unsigned int nPart, Particles
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::cp_particle_safe( unsigned int ipart, Particles &dest_parts )
 {
+    dest_parts.ensure_capacity( dest_parts.size()+1 );
+    
     unsigned int nprop = double_prop.size();
     if( dest_parts.double_prop.size() < nprop ) {
         nprop = dest_parts.double_prop.size();
@@ -576,6 +585,32 @@ void Particles::overwrite_part( unsigned int part1, unsigned int part2, unsigned
     }
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Move particle part1->part1+N into part2->part2+N memory location, the two ranges may overlap.
+// ---------------------------------------------------------------------------------------------------------------------
+void Particles::move_parts( unsigned int part1, unsigned int part2, unsigned int N )
+{
+    if( N==0 || part1==part2 ) {
+        return;
+    }
+    
+    unsigned int sizepart = N*sizeof( Position[0][0] );
+    unsigned int sizecharge = N*sizeof( Charge[0] );
+    unsigned int sizeid = N*sizeof( Id[0] );
+    
+    for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
+        memmove( & ( *double_prop[iprop] )[part2],  &( *double_prop[iprop] )[part1], sizepart );
+    }
+    
+    for( unsigned int iprop=0 ; iprop<short_prop.size() ; iprop++ ) {
+        memmove( & ( *short_prop[iprop] )[part2],  &( *short_prop[iprop] )[part1], sizecharge );
+    }
+    
+    for( unsigned int iprop=0 ; iprop<uint64_prop.size() ; iprop++ ) {
+        memmove( & ( *uint64_prop[iprop] )[part2],  &( *uint64_prop[iprop] )[part1], sizeid );
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 // Move particle part1 into part2 memory location of dest vector, erasing part2.
 // ---------------------------------------------------------------------------------------------------------------------
@@ -662,6 +697,8 @@ void Particles::push_to_end( unsigned int iPart )
 // ---------------------------------------------------------------------------------------------------------------------
 void Particles::create_particle()
 {
+    ensure_capacity( size()+1 );
+    
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
         ( *double_prop[iprop] ).push_back( 0. );
     }
@@ -682,6 +719,8 @@ void Particles::create_particle()
 void Particles::create_particles( int nAdditionalParticles )
 {
     int nParticles = size();
+    ensure_capacity( nParticles+nAdditionalParticles );
+    
     for( unsigned int iprop=0 ; iprop<double_prop.size() ; iprop++ ) {
         ( *double_prop[iprop] ).resize( nParticles+nAdditionalParticles, 0. );
     }
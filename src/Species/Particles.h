@@ -9,6 +9,16 @@
 
 #include "Tools.h"
 #include "TimeSelection.h"
+#include "AlignedAllocator.h"
+
+//! Floating-point type used to store the particle attributes
+//! (positions, momenta, weights, quantum parameter and optical depth).
+//! Fields and current accumulators are kept in double precision.
+#ifdef SMILEI_SINGLE_PRECISION
+typedef float particle_real;
+#else
+typedef double particle_real;
+#endif
 
 class Particle;
 
@@ -39,6 +49,14 @@ public:
     //! Set capacity of Particles vectors
     void reserve( unsigned int n_part_max, unsigned int nDim );
     
+    //! Grow the capacity of all Particles vectors together so that they can hold n_part particles
+    inline void ensure_capacity( unsigned int n_part )
+    {
+        if( n_part > capacity() ) {
+            grow( n_part );
+        }
+    }
+    
     //! Resize Particles vectors
     void resize( unsigned int nParticles, unsigned int nDim );
     
@@ -109,6 +127,9 @@ public:
     //! Overwrite particle part1->part1+N into part2->part2+N memory location. Erasing part2->part2+N
     void overwrite_part( unsigned int part1, unsigned int part2, unsigned int N );
     
+    //! Move particles part1->part1+N into part2->part2+N memory location, the two ranges may overlap
+    void move_parts( unsigned int part1, unsigned int part2, unsigned int N );
+    
     //! Overwrite particle part1->part1+N into part2->part2+N of dest_parts memory location. Erasing part2->part2+N
     void overwrite_part( unsigned int part1, Particles &dest_parts, unsigned int part2, unsigned int N );
     
@@ -134,7 +155,7 @@ public:
         return Position[idim][ipart];
     }
     //! Method used to set a new value to the Particle former position
-    inline double &position( unsigned int idim, unsigned int ipart )
+    inline particle_real &position( unsigned int idim, unsigned int ipart )
     {
         return Position[idim][ipart];
     }
@@ -151,13 +172,13 @@ public:
         return Position_old[idim][ipart];
     }
     //! Method used to set a new value to the Particle former position
-    inline double &position_old( unsigned int idim, unsigned int ipart )
+    inline particle_real &position_old( unsigned int idim, unsigned int ipart )
     {
         return Position_old[idim][ipart];
     }
     
     //! Method used to get the list of Particle position
-    inline std::vector<double>  position( unsigned int idim ) const
+    inline aligned_vector<particle_real>  position( unsigned int idim ) const
     {
         return Position[idim];
     }
@@ -168,12 +189,12 @@ public:
         return Momentum[idim][ipart];
     }
     //! Method used to set a new value to the Particle momentum
-    inline double &momentum( unsigned int idim, unsigned int ipart )
+    inline particle_real &momentum( unsigned int idim, unsigned int ipart )
     {
         return Momentum[idim][ipart];
     }
     //! Method used to get the Particle momentum
-    inline std::vector<double>  momentum( unsigned int idim ) const
+    inline aligned_vector<particle_real>  momentum( unsigned int idim ) const
     {
         return Momentum[idim];
     }
@@ -184,12 +205,12 @@ public:
         return Weight[ipart];
     }
     //! Method used to set a new value to the Particle weight
-    inline double &weight( unsigned int ipart )
+    inline particle_real &weight( unsigned int ipart )
     {
         return Weight[ipart];
     }
     //! Method used to get the Particle weight
-    inline std::vector<double>  weight() const
+    inline aligned_vector<particle_real>  weight() const
     {
         return Weight;
     }
@@ -205,7 +226,7 @@ public:
         return Charge[ipart];
     }
     //! Method used to get the list of Particle charges
-    inline std::vector<short>  charge() const
+    inline aligned_vector<short>  charge() const
     {
         return Charge;
     }
@@ -230,36 +251,77 @@ public:
     }
     
     //! Partiles properties, respect type order : all double, all short, all unsigned int
+    //! Each component is a SMILEI_ALIGNMENT-byte aligned buffer,
+    //! and all components share the same capacity (see ensure_capacity)
     
     //! array containing the particle position
-    std::vector< std::vector<double> > Position;
+    std::vector< aligned_vector<particle_real> > Position;
     
     //! array containing the particle former (old) positions
-    std::vector< std::vector<double> >Position_old;
+    std::vector< aligned_vector<particle_real> >Position_old;
     
     //! array containing the particle moments
-    std::vector< std::vector<double> >  Momentum;
+    std::vector< aligned_vector<particle_real> >  Momentum;
     
     //! containing the particle weight: equivalent to a charge density
-    std::vector<double> Weight;
+    aligned_vector<particle_real> Weight;
     
     //! containing the particle quantum parameter
-    std::vector<double> Chi;
+    aligned_vector<particle_real> Chi;
     
     //! charge state of the particle (multiples of e>0)
-    std::vector<short> Charge;
+    aligned_vector<short> Charge;
     
     //! Id of the particle
-    std::vector<uint64_t> Id;
+    aligned_vector<uint64_t> Id;
     
     // Discontinuous radiation losses
     
     //! Incremental optical depth for
     //! the Monte-Carlo process
-    std::vector<double> Tau;
+    aligned_vector<particle_real> Tau;
     
     //! cell_keys of the particle
-    std::vector<int> cell_keys;
+    aligned_vector<int> cell_keys;
+    
+    //! Pointers to the particle components, for vectorized kernels.
+    //! They are invalidated by any operation changing the capacity.
+    inline particle_real *__restrict__ getPtrPosition( unsigned int idim )
+    {
+        return Position[idim].data();
+    }
+    inline particle_real *__restrict__ getPtrPositionOld( unsigned int idim )
+    {
+        return Position_old[idim].data();
+    }
+    inline particle_real *__restrict__ getPtrMomentum( unsigned int idim )
+    {
+        return Momentum[idim].data();
+    }
+    inline particle_real *__restrict__ getPtrWeight()
+    {
+        return Weight.data();
+    }
+    inline short *__restrict__ getPtrCharge()
+    {
+        return Charge.data();
+    }
+    inline particle_real *__restrict__ getPtrChi()
+    {
+        return Chi.data();
+    }
+    inline particle_real *__restrict__ getPtrTau()
+    {
+        return Tau.data();
+    }
+    inline uint64_t *__restrict__ getPtrId()
+    {
+        return Id.data();
+    }
+    inline int *__restrict__ getPtrCellKeys()
+    {
+        return cell_keys.data();
+    }
     
     // TEST PARTICLE PARAMETERS
     bool is_test;
@@ -287,7 +349,7 @@ public:
         return Id[ipart];
     }
     //! Method used to get the Particle Ids
-    inline std::vector<uint64_t> id() const
+    inline aligned_vector<uint64_t> id() const
     {
         return Id;
     }
@@ -308,12 +370,12 @@ public:
         return Chi[ipart];
     }
     //! Method used to set a new value to the Particle chi factor
-    inline double &chi( unsigned int ipart )
+    inline particle_real &chi( unsigned int ipart )
     {
         return Chi[ipart];
     }
     //! Method used to get the Particle chi factor
-    inline std::vector<double>  chi() const
+    inline aligned_vector<particle_real>  chi() const
     {
         return Chi;
     }
@@ -325,20 +387,21 @@ public:
     }
     //! Method used to set a new value to
     //! the Particle optical depth
-    inline double &tau( unsigned int ipart )
+    inline particle_real &tau( unsigned int ipart )
     {
         return Tau[ipart];
     }
     //! Method used to get the Particle optical depth
-    inline std::vector<double>  tau() const
+    inline aligned_vector<particle_real>  tau() const
     {
         return Tau;
     }
     
     
-    std::vector< std::vector<double  >*> double_prop;
-    std::vector< std::vector<short   >*> short_prop;
-    std::vector< std::vector<uint64_t>*> uint64_prop;
+    //! double_prop holds all the floating-point properties (of type particle_real)
+    std::vector< aligned_vector<particle_real>*> double_prop;
+    std::vector< aligned_vector<short   >*> short_prop;
+    std::vector< aligned_vector<uint64_t>*> uint64_prop;
     
     
 #ifdef __DEBUG
@@ -363,21 +426,27 @@ public:
     Particle operator()( unsigned int iPart );
     
     //! Methods to obtain any property, given its index in the arrays double_prop, uint64_prop, or short_prop
-    void getProperty( unsigned int iprop, std::vector<uint64_t> *&prop )
+    void getProperty( unsigned int iprop, aligned_vector<uint64_t> *&prop )
     {
         prop = uint64_prop[iprop];
     }
-    void getProperty( unsigned int iprop, std::vector<short> *&prop )
+    void getProperty( unsigned int iprop, aligned_vector<short> *&prop )
     {
         prop = short_prop[iprop];
     }
-    void getProperty( unsigned int iprop, std::vector<double> *&prop )
+    void getProperty( unsigned int iprop, aligned_vector<particle_real> *&prop )
     {
         prop = double_prop[iprop];
     }
     
 private:
 
+    //! Factor applied to the capacity when the particle buffers must grow
+    static constexpr double growth_factor = 1.5;
+    
+    //! Reallocate all Particles vectors with a capacity of at least n_part
+    void grow( unsigned int n_part );
+
 };
 
 
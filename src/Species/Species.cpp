@@ -6,6 +6,7 @@
 #include <cstdlib>
 
 #include <iostream>
+#include <algorithm>
 
 #include <omp.h>
 
@@ -91,6 +92,8 @@ Species::Species( Params &params, Patch *patch ) :
     PI2 = 2.0 * M_PI;
     PI_ov_2 = 0.5*M_PI;
     
+    rand_ = patch->rand_;
+    
     dx_inv_[0] = 1./cell_length[0];
     dx_inv_[1] = 1./cell_length[1];
     dx_inv_[2] = 1./cell_length[2];
@@ -205,10 +208,10 @@ void Species::initOperators( Params &params, Patch *patch )
     Ionize = IonizationFactory::create( params, this );
     
     // Create the radiation model
-    Radiate = RadiationFactory::create( params, this );
+    Radiate = RadiationFactory::create( params, this, patch->rand_ );
     
     // Create the multiphoton Breit-Wheeler model
-    Multiphoton_Breit_Wheeler_process = MultiphotonBreitWheelerFactory::create( params, this );
+    Multiphoton_Breit_Wheeler_process = MultiphotonBreitWheelerFactory::create( params, this, patch->rand_ );
     // define limits for BC and functions applied and for domain decomposition
     partBoundCond = new PartBoundCond( params, this, patch );
     for( unsigned int iDim=0 ; iDim < nDim_particle ; iDim++ ) {
@@ -378,7 +381,7 @@ void Species::initPosition( unsigned int nPart, unsigned int iPart, double *inde
                 for (unsigned int ir = 0 ; ir < Np_array[1]; ir++){
                     double qr = indexes[1] + dr*(ir+0.5);
                     int nr = ir*(Np_array[2]);
-                    theta_offset = Rand::uniform()*2.*M_PI;
+                    theta_offset = rand_->uniform()*2.*M_PI;
                     for (unsigned int itheta = 0 ; itheta < Np_array[2]; itheta++){
                         int p = nx+nr+itheta+iPart;
                         double theta = theta_offset + itheta*dtheta;
@@ -394,16 +397,16 @@ void Species::initPosition( unsigned int nPart, unsigned int iPart, double *inde
         if( params.geometry=="AMcylindrical" ) {
             double particles_r, particles_theta;
             for( unsigned int p= iPart; p<iPart+nPart; p++ ) {
-                particles->position( 0, p )=indexes[0]+Rand::uniform()*cell_length[0];
-                particles_r=sqrt( indexes[1]*indexes[1]+ 2.*Rand::uniform()*( indexes[1]+cell_length[1]*0.5 )*cell_length[1] );
-                particles_theta=Rand::uniform()*2.*M_PI;
+                particles->position( 0, p )=indexes[0]+rand_->uniform()*cell_length[0];
+                particles_r=sqrt( indexes[1]*indexes[1]+ 2.*rand_->uniform()*( indexes[1]+cell_length[1]*0.5 )*cell_length[1] );
+                particles_theta=rand_->uniform()*2.*M_PI;
                 particles->position( 2, p )=particles_r*sin( particles_theta );
                 particles->position( 1, p )= particles_r*cos( particles_theta );
             }
         } else {
             for( unsigned int p= iPart; p<iPart+nPart; p++ ) {
                 for( unsigned int i=0; i<nDim_particle ; i++ ) {
-                    particles->position( i, p )=indexes[i]+Rand::uniform()*cell_length[i];
+                    particles->position( i, p )=indexes[i]+rand_->uniform()*cell_length[i];
                 }
             }
         }
@@ -448,8 +451,8 @@ void Species::initMomentum( unsigned int nPart, unsigned int iPart, double *temp
             
             // Sample angles randomly and calculate the momentum
             for( unsigned int p=iPart; p<iPart+nPart; p++ ) {
-                double phi   = acos( -Rand::uniform2() );
-                double theta = 2.0*M_PI*Rand::uniform();
+                double phi   = acos( -rand_->uniform2() );
+                double theta = 2.0*M_PI*rand_->uniform();
                 double psm = sqrt( pow( 1.0+energies[p-iPart], 2 )-1.0 );
                 
                 particles->momentum( 0, p ) = psm*cos( theta )*sin( phi );
@@ -471,9 +474,9 @@ void Species::initMomentum( unsigned int nPart, unsigned int iPart, double *temp
         
             double t0 = sqrt( temp[0]/mass ), t1 = sqrt( temp[1]/mass ), t2 = sqrt( temp[2]/mass );
             for( unsigned int p= iPart; p<iPart+nPart; p++ ) {
-                particles->momentum( 0, p ) = Rand::uniform2() * t0;
-                particles->momentum( 1, p ) = Rand::uniform2() * t1;
-                particles->momentum( 2, p ) = Rand::uniform2() * t2;
+                particles->momentum( 0, p ) = rand_->uniform2() * t0;
+                particles->momentum( 1, p ) = rand_->uniform2() * t1;
+                particles->momentum( 2, p ) = rand_->uniform2() * t2;
             }
         }
         
@@ -515,7 +518,7 @@ void Species::initMomentum( unsigned int nPart, unsigned int iPart, double *temp
                            + pow( particles->momentum( 2, p ), 2 ) );
                            
                 CheckVelocity = ( vx*particles->momentum( 0, p ) + vy*particles->momentum( 1, p ) + vz*particles->momentum( 2, p ) ) / gp;
-                Volume_Acc = Rand::uniform();
+                Volume_Acc = rand_->uniform();
                 if( CheckVelocity > Volume_Acc ) {
                 
                     double Phi, Theta, vfl, vflx, vfly, vflz, vpx, vpy, vpz ;
@@ -570,9 +573,9 @@ void Species::initMomentum( unsigned int nPart, unsigned int iPart, double *temp
         
             //double gamma =sqrt(temp[0]*temp[0] + temp[1]*temp[1] + temp[2]*temp[2]);
             for( unsigned int p= iPart; p<iPart+nPart; p++ ) {
-                particles->momentum( 0, p ) = Rand::uniform2()*temp[0];
-                particles->momentum( 1, p ) = Rand::uniform2()*temp[1];
-                particles->momentum( 2, p ) = Rand::uniform2()*temp[2];
+                particles->momentum( 0, p ) = rand_->uniform2()*temp[0];
+                particles->momentum( 1, p ) = rand_->uniform2()*temp[1];
+                particles->momentum( 2, p ) = rand_->uniform2()*temp[2];
             }
             
         }
@@ -1634,7 +1637,7 @@ int Species::createParticles( vector<unsigned int> n_space_to_create, Params &pa
 // Move all particles from another species to this one
 void Species::importParticles( Params &params, Patch *patch, Particles &source_particles, vector<Diagnostic *> &localDiags )
 {
-    unsigned int npart = source_particles.size(), ibin, ii, nbin=first_index.size();
+    unsigned int npart = source_particles.size(), nbin=first_index.size();
     double inv_cell_length = 1./ params.cell_length[0];
     
     // std::cerr << "Species::importParticles "
@@ -1651,25 +1654,97 @@ void Species::importParticles( Params &params, Patch *patch, Particles &source_p
         dynamic_cast<DiagnosticTrack *>( localDiags[tracking_diagnostic] )->setIDs( source_particles );
     }
     
-    // Move particles
+    // Receiving bin of each particle
+    vector<unsigned int> source_bin( npart );
     for( unsigned int i=0; i<npart; i++ ) {
-        // Copy particle to the correct bin
-        ibin = source_particles.position( 0, i )*inv_cell_length - ( patch->getCellStartingGlobalIndex( 0 ) + params.oversize[0] );
-        
-        ibin /= params.clrw;
-        source_particles.cp_particle( i, *particles, first_index[ibin] );
-        
-        // Update the bin counts
-        last_index[ibin]++;
-        for( ii=ibin+1; ii<nbin; ii++ ) {
-            first_index[ii]++;
-            last_index[ii]++;
-        }
+        unsigned int ibin = source_particles.position( 0, i )*inv_cell_length - ( patch->getCellStartingGlobalIndex( 0 ) + params.oversize[0] );
+        source_bin[i] = min( ibin / params.clrw, nbin-1 );
     }
     
+    // Move particles at the beginning of their bin
+    insertParticlesInBins( source_particles, source_bin, true, false );
+    
     source_particles.clear();
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Insert all the particles of source_particles in the bins given by source_bin, in a single pass:
+//   - the number of new particles per bin is prefix-summed into the shift of each bin,
+//   - each bin is then moved once towards the end of the arrays, starting from the last one,
+//   - the new particles are finally copied into the slots left free.
+// New particles are placed at the beginning of their bin (in reverse order) if at_bin_start,
+// or at its end otherwise, as successive insertions would have done.
+// Particles out of the bins (between two bins or after the last one) are shifted as well.
+// ---------------------------------------------------------------------------------------------------------------------
+void Species::insertParticlesInBins( Particles &source_particles, vector<unsigned int> &source_bin, bool at_bin_start, bool with_cell_keys )
+{
+    unsigned int npart = source_particles.size(), nbin = first_index.size();
+    if( npart == 0 ) {
+        return;
+    }
+    
+    // shift[ibin] = number of new particles in the bins before ibin
+    vector<unsigned int> shift( nbin+1, 0 );
+    for( unsigned int i=0; i<npart; i++ ) {
+        shift[source_bin[i]+1]++;
+    }
+    for( unsigned int ibin=0; ibin<nbin; ibin++ ) {
+        shift[ibin+1] += shift[ibin];
+    }
+    
+    unsigned int old_size = particles->size();
+    particles->create_particles( npart );
+    if( with_cell_keys ) {
+        particles->cell_keys.resize( old_size+npart );
+    }
+    
+    // Relocate the bins, from the last one as particles only move towards the end
+    for( int ibin=nbin-1; ibin>=0; ibin-- ) {
+        unsigned int bin_end = ( ibin+1 < ( int )nbin ) ? first_index[ibin+1] : old_size;
+        unsigned int n_new = shift[ibin+1] - shift[ibin];
+        // Particles after the bin, before the next one
+        particles->move_parts( last_index[ibin], last_index[ibin]+shift[ibin+1], bin_end-last_index[ibin] );
+        // Particles of the bin
+        unsigned int bin_start = first_index[ibin] + shift[ibin] + ( at_bin_start ? n_new : 0 );
+        particles->move_parts( first_index[ibin], bin_start, last_index[ibin]-first_index[ibin] );
+        if( with_cell_keys ) {
+            aligned_vector<int>::iterator keys = particles->cell_keys.begin();
+            copy_backward( keys+last_index[ibin], keys+bin_end, keys+bin_end+shift[ibin+1] );
+            copy_backward( keys+first_index[ibin], keys+last_index[ibin], keys+bin_start+last_index[ibin]-first_index[ibin] );
+        }
+        first_index[ibin] += shift[ibin];
+        last_index[ibin]  += shift[ibin+1];
+    }
+    
+    // Slot of each new particle
+    vector<unsigned int> dest( npart );
+    if( at_bin_start ) {
+        for( unsigned int ibin=0; ibin<nbin; ibin++ ) {
+            shift[ibin] = first_index[ibin] + shift[ibin+1] - shift[ibin];
+        }
+        for( unsigned int i=0; i<npart; i++ ) {
+            dest[i] = --shift[source_bin[i]];
+        }
+    } else {
+        for( unsigned int ibin=0; ibin<nbin; ibin++ ) {
+            shift[ibin] = last_index[ibin] - ( shift[ibin+1] - shift[ibin] );
+        }
+        for( unsigned int i=0; i<npart; i++ ) {
+            dest[i] = shift[source_bin[i]]++;
+        }
+    }
+    
+    // Copy the new particles, shared among the threads for large imports
+#ifdef _OMPTASKS
+    #pragma omp taskloop grainsize( 1024 ) if( npart > 4096 )
+#endif
+    for( unsigned int i=0; i<npart; i++ ) {
+        source_particles.overwrite_part( i, *particles, dest[i] );
+        if( with_cell_keys ) {
+            particles->cell_keys[dest[i]] = source_bin[i];
+        }
+    }
+}
 
 // ------------------------------------------------
 // Set position when using restart & moving window
@@ -1734,7 +1809,7 @@ vector<double> Species::maxwellJuttner( unsigned int npoints, double temperature
         // For each particle
         for( unsigned int i=0; i<npoints; i++ ) {
             // Pick a random number
-            U = Rand::uniform();
+            U = rand_->uniform();
             // Calculate the inverse of F
             lnlnU = log( -log( U ) );
             if( lnlnU>2. ) {
@@ -1763,7 +1838,7 @@ vector<double> Species::maxwellJuttner( unsigned int npoints, double temperature
         for( unsigned int i=0; i<npoints; i++ ) {
             do {
                 // Pick a random number
-                U = Rand::uniform();
+                U = rand_->uniform();
                 // Calculate the inverse of H at the point log(1.-U) + H0
                 lnU = log( -log( 1.-U ) - H0 );
                 if( lnU<-26. ) {
@@ -1779,7 +1854,7 @@ vector<double> Species::maxwellJuttner( unsigned int npoints, double temperature
                 // Make a first guess for the value of gamma
                 gamma = temperature * invH;
                 // We use the rejection method, so we pick another random number
-                U = Rand::uniform();
+                U = rand_->uniform();
                 // And we are done only if U < beta, otherwise we try again
             } while( U >= sqrt( 1.-1./( gamma*gamma ) ) );
             // Store that value of the energy
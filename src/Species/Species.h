@@ -250,6 +250,9 @@ public:
     //! Boundary condition for the Particles of the considered Species
     PartBoundCond *partBoundCond;
     
+    //! Random number generator of the patch (not owned)
+    Random *rand_;
+    
     //! Particles pusher (change momentum & change position, only momentum in case envelope model is used)
     Pusher *Push;
     
@@ -489,7 +492,7 @@ public:
             speciesSize += sizeof ( unsigned int );*/
         //speciesSize *= getNbrOfParticles();
         int speciesSize( 0 );
-        speciesSize += particles->double_prop.size()*sizeof( double );
+        speciesSize += particles->double_prop.size()*sizeof( particle_real );
         speciesSize += particles->short_prop.size()*sizeof( short );
         speciesSize += particles->uint64_prop.size()*sizeof( uint64_t );
         speciesSize *= getParticlesCapacity();
@@ -529,6 +532,9 @@ protected:
     //! Patch length
     unsigned int length_[3];
     
+    //! Insert all the particles of source_particles in the bins source_bin, moving each bin only once
+    void insertParticlesInBins( Particles &source_particles, std::vector<unsigned int> &source_bin, bool at_bin_start, bool with_cell_keys );
+    
 private:
     //! Number of steps for Maxwell-Juettner cumulative function integration
     //! \todo{Put in a code constant class}
@@ -697,6 +697,7 @@ public:
         if( !params.restart ) {
             // does a loop over all cells in the simulation
             // considering a 3d volume with size n_space[0]*n_space[1]*n_space[2]
+            patch->rand_->stream( patch->Hindex(), 0, Random::creation, ispec );
             thisSpecies->createParticles( params.n_space, params, patch, 0 );
             //MESSAGE(" PARTICLES");
         } else {
@@ -804,6 +805,7 @@ public:
 
         // \todo : NOT SURE HOW THIS BEHAVES WITH RESTART
         if( ( !params.restart ) && ( with_particles ) ) {
+            patch->rand_->stream( patch->Hindex(), 0, Random::creation, newSpecies->speciesNumber );
             newSpecies->createParticles( params.n_space, params, patch, 0 );
         } else {
             newSpecies->particles->initialize( 0, ( *species->particles ) );
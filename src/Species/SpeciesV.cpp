@@ -619,7 +619,7 @@ void SpeciesV::compute_bin_cell_keys( Params &params, int istart, int iend )
 void SpeciesV::importParticles( Params &params, Patch *patch, Particles &source_particles, vector<Diagnostic *> &localDiags )
 {
 
-    unsigned int npart = source_particles.size(), scell, ii, nbin=first_index.size();
+    unsigned int npart = source_particles.size(), scell;
     
     // If this species is tracked, set the particle IDs
     if( particles->tracked ) {
@@ -643,32 +643,22 @@ void SpeciesV::importParticles( Params &params, Patch *patch, Particles &source_
     //           << " nbp: " << npart
     //           << std::endl;
     
-    // Move particles
+    // Receiving bin (cell) of each particle
+    vector<unsigned int> source_bin( npart );
     for( unsigned int i=0; i<npart; i++ ) {
-    
-        // Compute the receiving bin index
         scell = 0;
         for( unsigned int ipos=0; ipos < nDim_particle ; ipos++ ) {
             X = source_particles.position( ipos, i )-min_loc_vec[ipos];
             IX = round( X * dx_inv_[ipos] );
             scell = scell * length[ipos] + IX;
         }
-        
-        // Copy particle to the correct bin
-        source_particles.cp_particle( i, *particles, last_index[scell] );
-        
-        // Update the bin counts
-        last_index[scell]++;
-        for( ii=scell+1; ii<nbin; ii++ ) {
-            first_index[ii]++;
-            last_index[ii]++;
-        }
-        
-        particles->cell_keys.insert( particles->cell_keys.begin() + first_index[scell] + count[scell], scell );
+        source_bin[i] = scell;
         count[scell] ++ ;
-        
     }
     
+    // Move particles at the end of their bin
+    insertParticlesInBins( source_particles, source_bin, false, true );
+    
     source_particles.clear();
 }
 
@@ -141,7 +141,7 @@ void SpeciesVAdaptiveMixedSort::importParticles( Params &params, Patch *patch, P
 {
 
     if( vectorized_operators ) {
-        importParticles( params, patch, source_particles, localDiags );
+        SpeciesV::importParticles( params, patch, source_particles, localDiags );
     } else {
         Species::importParticles( params, patch, source_particles, localDiags );
     }
@@ -0,0 +1,80 @@
+// -----------------------------------------------------------------------------
+//
+//! \file AlignedAllocator.h
+//
+//! \brief Minimal allocator returning memory aligned on a given boundary,
+//! used to store the particle components so that vectorized kernels can
+//! rely on cache-line aligned slices.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+//! Alignment (in bytes) of the particle component buffers: one cache line,
+//! which is also the width of an AVX-512 register
+#ifndef SMILEI_ALIGNMENT
+#define SMILEI_ALIGNMENT 64
+#endif
+
+template<typename T, std::size_t Alignment = SMILEI_ALIGNMENT>
+class AlignedAllocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() noexcept {}
+    template<typename U>
+    AlignedAllocator( const AlignedAllocator<U, Alignment> & ) noexcept {}
+
+    //! Allocate n elements on an Alignment-byte boundary
+    T *allocate( std::size_t n )
+    {
+        if( n == 0 ) {
+            return nullptr;
+        }
+        void *p = nullptr;
+        if( posix_memalign( &p, Alignment, n * sizeof( T ) ) != 0 ) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>( p );
+    }
+
+    void deallocate( T *p, std::size_t )
+    {
+        free( p );
+    }
+
+    template<typename U>
+    bool operator==( const AlignedAllocator<U, Alignment> & ) const noexcept
+    {
+        return true;
+    }
+    template<typename U>
+    bool operator!=( const AlignedAllocator<U, Alignment> & ) const noexcept
+    {
+        return false;
+    }
+};
+
+//! std::vector whose buffer starts on a SMILEI_ALIGNMENT-byte boundary
+template<typename T>
+using aligned_vector = std::vector<T, AlignedAllocator<T> >;
+
+#endif
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <vector>
 #include "Tools.h"
+#include "AlignedAllocator.h"
 
 #if ! H5_HAVE_PARALLEL == 1
 #error "HDF5 was not built with --enable-parallel option"
@@ -300,9 +301,27 @@ public:
     }
     
     
+    //! write an aligned vector<short>
+    static void vect( hid_t locationId, std::string name, aligned_vector<short> &v, int deflate=0 )
+    {
+        vect( locationId, name, v[0], v.size(), H5T_NATIVE_SHORT, deflate );
+    }
+    
+    //! write an aligned vector<doubles>
+    static void vect( hid_t locationId, std::string name, aligned_vector<double> &v, int deflate=0 )
+    {
+        vect( locationId, name, v[0], v.size(), H5T_NATIVE_DOUBLE, deflate );
+    }
+    
+    //! write an aligned vector<floats>
+    static void vect( hid_t locationId, std::string name, aligned_vector<float> &v, int deflate=0 )
+    {
+        vect( locationId, name, v[0], v.size(), H5T_NATIVE_FLOAT, deflate );
+    }
+    
     //! write any vector
-    template<class T>
-    static void vect( hid_t locationId, std::string name, std::vector<T> v, hid_t type, int deflate=0 )
+    template<class T, class A>
+    static void vect( hid_t locationId, std::string name, std::vector<T, A> &v, hid_t type, int deflate=0 )
     {
         vect( locationId, name, v[0], v.size(), type, deflate );
     }
@@ -358,9 +377,27 @@ public:
         getVect( locationId, vect_name, vect, H5T_NATIVE_SHORT, resizeVect );
     }
     
+    //! retrieve an aligned double vector
+    static void getVect( hid_t locationId, std::string vect_name,  aligned_vector<double> &vect, bool resizeVect=false )
+    {
+        getVect( locationId, vect_name, vect, H5T_NATIVE_DOUBLE, resizeVect );
+    }
+    
+    //! retrieve an aligned float vector (converted by HDF5 if stored as double)
+    static void getVect( hid_t locationId, std::string vect_name,  aligned_vector<float> &vect, bool resizeVect=false )
+    {
+        getVect( locationId, vect_name, vect, H5T_NATIVE_FLOAT, resizeVect );
+    }
+    
+    //! retrieve an aligned short vector
+    static void getVect( hid_t locationId, std::string vect_name,  aligned_vector<short> &vect, bool resizeVect=false )
+    {
+        getVect( locationId, vect_name, vect, H5T_NATIVE_SHORT, resizeVect );
+    }
+    
     //! template to read generic 1d vector
-    template<class T>
-    static void getVect( hid_t locationId, std::string vect_name, std::vector<T> &vect, hid_t type, bool resizeVect=false )
+    template<class T, class A>
+    static void getVect( hid_t locationId, std::string vect_name, std::vector<T, A> &vect, hid_t type, bool resizeVect=false )
     {
         hid_t did = H5Dopen( locationId, vect_name.c_str(), H5P_DEFAULT );
         hid_t sid = H5Dget_space( did );
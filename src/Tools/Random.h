@@ -0,0 +1,143 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <cmath>
+
+//  --------------------------------------------------------------------------------------------------------------------
+//! Class Random: counter-based random number generator (Philox-4x32-10, Salmon et al., SC'11)
+//!
+//! Each random number is a pure function of the seed, of the selected stream and of its rank in this stream.
+//! A stream is identified by the patch (Hilbert index), the iteration, the operator drawing the numbers and an
+//! index (species, collision...). The numbers drawn in a patch therefore do not depend on the number of threads,
+//! on the order in which patches are treated, on the load balancing, nor on checkpoint/restart.
+//  --------------------------------------------------------------------------------------------------------------------
+class Random
+{
+public:
+    //! Operators drawing random numbers, each of them has its own streams
+    enum Purpose {
+        dynamics = 0,       // ionization, radiation, pair creation, boundary conditions
+        collisions = 1,     // binary collisions and collisional ionization
+        creation = 2        // initialization of the particle positions and momenta
+    };
+    
+    //! Constructor, streams are selected with stream()
+    Random( uint32_t seed ) : seed_( seed )
+    {
+        stream( 0, 0, dynamics, 0 );
+    }
+    
+    //! Select a stream and rewind it
+    //! \param patch   Hilbert index of the patch
+    //! \param itime   iteration
+    //! \param purpose operator drawing the numbers
+    //! \param index   species or collision index
+    inline void stream( uint32_t patch, uint32_t itime, uint32_t purpose, uint32_t index )
+    {
+        key_[0] = seed_;
+        key_[1] = patch;
+        counter_[0] = 0;
+        counter_[1] = itime;
+        counter_[2] = index;
+        counter_[3] = purpose;
+        nbuffered_ = 0;
+    }
+    
+    //! Random 32-bit integer
+    inline uint32_t integer()
+    {
+        if( nbuffered_ == 0 ) {
+            philox( counter_[0]++, counter_[1], counter_[2], counter_[3], key_[0], key_[1], buffer_[0], buffer_[1], buffer_[2], buffer_[3] );
+            nbuffered_ = 4;
+        }
+        return buffer_[--nbuffered_];
+    }
+    
+    //! Uniform random number in ]0, 1[
+    inline double uniform()
+    {
+        return toUniform( integer() );
+    }
+    
+    //! Uniform random number in ]-1, 1[
+    inline double uniform2()
+    {
+        return 2.*uniform() - 1.;
+    }
+    
+    //! Normal random number of standard deviation stddev (Box-Muller)
+    inline double normal( double stddev )
+    {
+        double r = std::sqrt( -2.*std::log( uniform() ) );
+        return stddev * r * std::cos( 2.*M_PI*uniform() );
+    }
+    
+    //! Fill buffer with n uniform random numbers in ]0, 1[
+    //! The numbers are generated one block (4 numbers) per iteration, in a loop that can be vectorized
+    void fill( double *buffer, unsigned int n )
+    {
+        uint32_t c0 = counter_[0], c1 = counter_[1], c2 = counter_[2], c3 = counter_[3];
+        uint32_t k0 = key_[0], k1 = key_[1];
+        unsigned int nblock = n/4;
+        double *buffer0 = buffer;
+        double *buffer1 = buffer+nblock;
+        double *buffer2 = buffer+2*nblock;
+        double *buffer3 = buffer+3*nblock;
+        #pragma omp simd
+        for( unsigned int iblock=0; iblock<nblock; iblock++ ) {
+            uint32_t r0, r1, r2, r3;
+            philox( c0+iblock, c1, c2, c3, k0, k1, r0, r1, r2, r3 );
+            buffer0[iblock] = toUniform( r0 );
+            buffer1[iblock] = toUniform( r1 );
+            buffer2[iblock] = toUniform( r2 );
+            buffer3[iblock] = toUniform( r3 );
+        }
+        counter_[0] += nblock;
+        nbuffered_ = 0;
+        for( unsigned int i=4*nblock; i<n; i++ ) {
+            buffer[i] = uniform();
+        }
+    }
+    
+private:
+    //! Seed of the simulation
+    uint32_t seed_;
+    //! Key of the current stream
+    uint32_t key_[2];
+    //! Counter: index of the next block in the stream, iteration, index and purpose
+    uint32_t counter_[4];
+    //! Numbers of the current block not drawn yet
+    uint32_t buffer_[4];
+    unsigned int nbuffered_;
+    
+    //! Conversion of a 32-bit integer to a double in ]0, 1[
+    static inline double toUniform( uint32_t r )
+    {
+        return ( ( double )r + 0.5 ) * 2.3283064365386963e-10;
+    }
+    
+    //! Philox-4x32 bijection with 10 rounds, from counter (c0, c1, c2, c3) and key (k0, k1)
+    static inline void philox( uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1,
+                               uint32_t &r0, uint32_t &r1, uint32_t &r2, uint32_t &r3 )
+    {
+        for( int iround=0; iround<10; iround++ ) {
+            uint64_t p0 = ( uint64_t )0xD2511F53u * c0;
+            uint64_t p1 = ( uint64_t )0xCD9E8D57u * c2;
+            uint32_t t0 = ( uint32_t )( p1 >> 32 ) ^ c1 ^ k0;
+            uint32_t t2 = ( uint32_t )( p0 >> 32 ) ^ c3 ^ k1;
+            c1 = ( uint32_t )p1;
+            c3 = ( uint32_t )p0;
+            c0 = t0;
+            c2 = t2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        r0 = c0;
+        r1 = c1;
+        r2 = c2;
+        r3 = c3;
+    }
+};
+
+#endif
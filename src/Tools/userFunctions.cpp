@@ -662,3 +662,30 @@ int userFunctions::search_elem_in_array( double *array,
         return imin;
     }
 }
+
+// ----------------------------------------------------------------------------
+//! \brief Build a guide table for a non-decreasing array of values in [0,1].
+//! guide[k] is the last index i (at most nb_elems-2) so that
+//! array[i] <= k/nb_guide, or 0 if there is none. A search for elem in
+//! [k/nb_guide,(k+1)/nb_guide[ can then start from guide[k] and usually
+//! stops after a few elements.
+//
+//! \param array array in which the values will be searched
+//! \param nb_elem number of elements
+//! \param guide guide table of nb_guide elements
+//! \param nb_guide number of elements of the guide table
+// ----------------------------------------------------------------------------
+void userFunctions::build_guide_table( double *array,
+                                       int nb_elems,
+                                       int *guide,
+                                       int nb_guide )
+{
+    int i = 0;
+    for( int k=0 ; k<nb_guide ; k++ ) {
+        double elem = ( double )k/nb_guide;
+        while( i < nb_elems-2 && array[i+1] <= elem ) {
+            i++;
+        }
+        guide[k] = i;
+    }
+}
@@ -52,6 +52,40 @@ public:
                                      double elem,
                                      int nb_elems );
                                      
+    //! Build a guide table for a non-decreasing array of values in [0,1]:
+    //! guide[k] is the last index i (at most nb_elems-2) so that array[i] <= k/nb_guide
+    //
+    //! \param array array in which the values will be searched
+    //! \param nb_elem number of elements
+    //! \param guide guide table of nb_guide elements
+    //! \param nb_guide number of elements of the guide table
+    static void build_guide_table( double *array,
+                                   int nb_elems,
+                                   int *guide,
+                                   int nb_guide );
+                                   
+    //! Same result as search_elem_in_array, for elem in [0,1] and array[0] <= elem:
+    //! the search starts from the guide table instead of a bijection
+    //
+    //! \param array array in which to find the value
+    //! \param elem element to be found
+    //! \param nb_elem number of elements
+    //! \param guide guide table built by build_guide_table
+    //! \param nb_guide number of elements of the guide table
+    static inline int search_elem_in_guided_array( double *array,
+            double elem,
+            int nb_elems,
+            int *guide,
+            int nb_guide )
+    {
+        int k = int( elem*nb_guide );
+        int i = guide[k < nb_guide ? k : nb_guide-1];
+        while( i < nb_elems-2 && array[i+1] <= elem ) {
+            i++;
+        }
+        return i;
+    }
+    
 private:
 
 